@@ -19,6 +19,7 @@
  * limitations under the License.
  */
 #include "ros_catkin_make_step.h"
+#include "ros_cmake_file_api.h"
 #include "ros_project_constants.h"
 #include "ros_project.h"
 #include "ui_ros_catkin_make_step.h"
@@ -32,6 +33,7 @@
 #include <projectexplorer/projectexplorerconstants.h>
 #include <projectexplorer/toolchain.h>
 #include <qtsupport/qtparser.h>
+#include <utils/async.h>
 #include <utils/stringutils.h>
 #include <utils/qtcassert.h>
 #include <cmakeprojectmanager/cmakeparser.h>
@@ -54,7 +56,8 @@ const char ROS_CMS_CMAKE_ARGUMENTS_KEY[] = "ROSProjectManager.ROSCatkinMakeStep.
 const char ROS_CMS_MAKE_ARGUMENTS_KEY[] = "ROSProjectManager.ROSCatkinMakeStep.MakeArguments";
 
 ROSCatkinMakeStep::ROSCatkinMakeStep(BuildStepList *parent, const Utils::Id id) :
-    AbstractProcessStep(parent, id)
+    AbstractProcessStep(parent, id),
+    m_writingQueries(false)
 {
     setDefaultDisplayName(QCoreApplication::translate("ROSProjectManager::Internal::ROSCatkinMakeStep",
                                                       ROS_CMS_DISPLAY_NAME));
@@ -69,6 +72,17 @@ ROSCatkinMakeStep::ROSCatkinMakeStep(BuildStepList *parent, const Utils::Id id)
         if (format == OutputFormat::Stdout)
             stdOutput(string);
     });
+
+    connect(&m_queryWatcher, &QFutureWatcher<void>::finished, this, [this]() {
+        m_writingQueries = false;
+        if (m_queryWatcher.isCanceled())
+        {
+            emit finished(false);
+            return;
+        }
+
+        AbstractProcessStep::doRun();
+    });
 }
 
 ROSBuildConfiguration *ROSCatkinMakeStep::rosBuildConfiguration() const
@@ -117,6 +131,10 @@ bool ROSCatkinMakeStep::init()
     pp->setEnvironment(env);
     pp->setCommandLine(makeCommand(allArguments(bc->cmakeBuildType())));
 
+    // CMake only answers File API queries that exist before it configures, they are written in doRun()
+    m_queryWorkspaceInfo = workspaceInfo;
+    m_queryPackageInfo = bc->project()->getPackageInfo();
+
     // If we are cleaning, then make can fail with an error code, but that doesn't mean
     // we should stop the clean queue
     // That is mostly so that rebuild works on an already clean project
@@ -125,6 +143,31 @@ bool ROSCatkinMakeStep::init()
     return AbstractProcessStep::init();
 }
 
+void ROSCatkinMakeStep::doRun()
+{
+    if (m_target != BUILD)
+    {
+        AbstractProcessStep::doRun();
+        return;
+    }
+
+    // Writing a query per package touches every build directory, which must not block the GUI thread
+    m_writingQueries = true;
+    m_queryWatcher.setFuture(Utils::asyncRun(ProjectExplorerPlugin::sharedThreadPool(), &ROSCMakeFileApi::writeQueries,
+                                             m_queryWorkspaceInfo, m_queryPackageInfo));
+}
+
+void ROSCatkinMakeStep::doCancel()
+{
+    if (m_writingQueries)
+    {
+        m_queryWatcher.cancel();
+        return;
+    }
+
+    AbstractProcessStep::doCancel();
+}
+
 void ROSCatkinMakeStep::setupOutputFormatter(Utils::OutputFormatter *formatter)
 {
     formatter->addLineParser(new GnuMakeParser);
@@ -174,9 +217,9 @@ QString ROSCatkinMakeStep::allArguments(ROSUtils::BuildType buildType, bool incl
         args << m_catkinMakeArguments;
         if (includeDefault)
             if (buildType == ROSUtils::BuildTypeUserDefined)
-                args << QString("--cmake-args -G \"CodeBlocks - Unix Makefiles\" %1").arg(m_cmakeArguments);
+                args << QString("--cmake-args %1 %2").arg(ROSUtils::getCMakeGeneratorArgument(m_cmakeArguments, buildEnvironment()), m_cmakeArguments);
             else
-                args << QString("--cmake-args -G \"CodeBlocks - Unix Makefiles\" %1 %2").arg(ROSUtils::getCMakeBuildTypeArgument(buildType), m_cmakeArguments);
+                args << QString("--cmake-args %1 %2 %3").arg(ROSUtils::getCMakeGeneratorArgument(m_cmakeArguments, buildEnvironment()), ROSUtils::getCMakeBuildTypeArgument(buildType), m_cmakeArguments);
         else
             if (!m_cmakeArguments.isEmpty())
                 args << QString("--cmake-args %1").arg(m_cmakeArguments);
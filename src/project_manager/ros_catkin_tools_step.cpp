@@ -19,6 +19,7 @@
  * limitations under the License.
  */
 #include "ros_catkin_tools_step.h"
+#include "ros_cmake_file_api.h"
 #include "ros_project_constants.h"
 #include "ros_project.h"
 #include "ui_ros_catkin_tools_step.h"
@@ -34,6 +35,7 @@
 #include <projectexplorer/projectexplorerconstants.h>
 #include <projectexplorer/toolchain.h>
 #include <qtsupport/qtparser.h>
+#include <utils/async.h>
 #include <utils/stringutils.h>
 #include <utils/qtcassert.h>
 #include <cmakeprojectmanager/cmakeparser.h>
@@ -60,7 +62,8 @@ const char ROS_CTS_CMAKE_ARGUMENTS_KEY[] = "ROSProjectManager.ROSCatkinToolsStep
 const char ROS_CTS_MAKE_ARGUMENTS_KEY[] = "ROSProjectManager.ROSCatkinToolsStep.MakeArguments";
 
 ROSCatkinToolsStep::ROSCatkinToolsStep(BuildStepList *parent, const Utils::Id id) :
-    AbstractProcessStep(parent, id)
+    AbstractProcessStep(parent, id),
+    m_writingQueries(false)
 {
     m_catkinToolsWorkingDir = Constants::ROS_DEFAULT_WORKING_DIR;
 
@@ -80,6 +83,17 @@ ROSCatkinToolsStep::ROSCatkinToolsStep(BuildStepList *parent, const Utils::Id id
         if (format == OutputFormat::Stdout)
             stdOutput(string);
     });
+
+    connect(&m_queryWatcher, &QFutureWatcher<void>::finished, this, [this]() {
+        m_writingQueries = false;
+        if (m_queryWatcher.isCanceled())
+        {
+            emit finished(false);
+            return;
+        }
+
+        AbstractProcessStep::doRun();
+    });
 }
 
 ROSBuildConfiguration *ROSCatkinToolsStep::rosBuildConfiguration() const
@@ -129,6 +143,10 @@ bool ROSCatkinToolsStep::init()
     pp->setEnvironment(env);
     pp->setCommandLine(makeCommand(allArguments(bc->cmakeBuildType())));
 
+    // CMake only answers File API queries that exist before it configures, they are written in doRun()
+    m_queryWorkspaceInfo = workspaceInfo;
+    m_queryPackageInfo = bc->project()->getPackageInfo();
+
     // If we are cleaning, then make can fail with an error code, but that doesn't mean
     // we should stop the clean queue
     // That is mostly so that rebuild works on an already clean project
@@ -137,6 +155,31 @@ bool ROSCatkinToolsStep::init()
     return AbstractProcessStep::init();
 }
 
+void ROSCatkinToolsStep::doRun()
+{
+    if (m_target != BUILD)
+    {
+        AbstractProcessStep::doRun();
+        return;
+    }
+
+    // Writing a query per package touches every build directory, which must not block the GUI thread
+    m_writingQueries = true;
+    m_queryWatcher.setFuture(Utils::asyncRun(ProjectExplorerPlugin::sharedThreadPool(), &ROSCMakeFileApi::writeQueries,
+                                             m_queryWorkspaceInfo, m_queryPackageInfo));
+}
+
+void ROSCatkinToolsStep::doCancel()
+{
+    if (m_writingQueries)
+    {
+        m_queryWatcher.cancel();
+        return;
+    }
+
+    AbstractProcessStep::doCancel();
+}
+
 void ROSCatkinToolsStep::setupOutputFormatter(Utils::OutputFormatter *formatter)
 {
     formatter->addLineParser(new GnuMakeParser);
@@ -199,7 +242,7 @@ QString ROSCatkinToolsStep::allArguments(ROSUtils::BuildType buildType, bool inc
             args << QString("--catkin-make-args %1").arg(m_catkinMakeArguments);
 
         if (includeDefault)
-            args << QString("--cmake-args -G \"CodeBlocks - Unix Makefiles\" %1 %2").arg(ROSUtils::getCMakeBuildTypeArgument(buildType), m_cmakeArguments);
+            args << QString("--cmake-args %1 %2 %3").arg(ROSUtils::getCMakeGeneratorArgument(m_cmakeArguments, buildEnvironment()), ROSUtils::getCMakeBuildTypeArgument(buildType), m_cmakeArguments);
         else
             if (!m_cmakeArguments.isEmpty())
                 args << QString("--cmake-args %1").arg(m_cmakeArguments);
@@ -25,6 +25,8 @@
 
 #include "ros_build_configuration.h"
 
+#include <QFutureWatcher>
+
 #include <QDialog>
 #include <QLineEdit>
 #include <yaml-cpp/yaml.h>
@@ -77,6 +79,8 @@ protected:
     QStringList automaticallyAddedArguments() const;
     void fromMap(const Utils::Store &map) override;
     QWidget *createConfigWidget() override;
+    void doRun() override;
+    void doCancel() override;
 
 private:
     ROSBuildConfiguration *targetsActiveBuildConfiguration() const;
@@ -90,6 +94,12 @@ private:
     QString m_makeArguments;
     QString m_catkinToolsWorkingDir;
     QRegularExpression m_percentProgress;
+
+    // The File API queries are written on a worker thread before the build process starts
+    ROSUtils::WorkspaceInfo m_queryWorkspaceInfo;
+    ROSUtils::PackageInfoMap m_queryPackageInfo;
+    QFutureWatcher<void> m_queryWatcher;
+    bool m_writingQueries;
 };
 
 class ROSCatkinToolsStepWidget : public QWidget
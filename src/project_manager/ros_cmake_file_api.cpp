@@ -0,0 +1,298 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ros_cmake_file_api.h"
+
+#include <utils/hostosinfo.h>
+#include <utils/processargs.h>
+
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+
+namespace ROSProjectManager {
+namespace Internal {
+
+// Queries in a client directory are answered without touching queries of other tools
+static const char FILE_API_CLIENT[] = "client-ros_qtc_plugin";
+static const char FILE_API_CODEMODEL[] = "codemodel-v2";
+
+/** @brief Read a reply file, an empty object is returned on error */
+static QJsonObject readJsonObject(const Utils::FilePath &file)
+{
+    QFile jsonFile(file.toString());
+    if (!jsonFile.open(QFile::ReadOnly))
+        return QJsonObject();
+
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(jsonFile.readAll(), &error);
+    if (error.error != QJsonParseError::NoError || !document.isObject())
+        return QJsonObject();
+
+    return document.object();
+}
+
+/** @brief Get the package directory a path is in, an empty string if it is in none */
+static QString packageOf(const QSet<QString> &packagePaths, const QString &path)
+{
+    for (QString directory = path; !directory.isEmpty(); directory.truncate(directory.lastIndexOf(QLatin1Char('/'))))
+    {
+        if (packagePaths.contains(directory))
+            return directory;
+    }
+
+    return QString();
+}
+
+static ROSUtils::TargetType targetType(const QString &type)
+{
+    if (type == QLatin1String("EXECUTABLE"))
+        return ROSUtils::ExecutableType;
+
+    if (type == QLatin1String("STATIC_LIBRARY") || type == QLatin1String("OBJECT_LIBRARY"))
+        return ROSUtils::StaticLibraryType;
+
+    if (type == QLatin1String("SHARED_LIBRARY") || type == QLatin1String("MODULE_LIBRARY"))
+        return ROSUtils::DynamicLibraryType;
+
+    return ROSUtils::UtilityType;
+}
+
+/**
+ * @brief Read a target reply, every C and C++ compile group becomes a PackageTargetInfo
+ * @param file Path to the target reply
+ * @param sourceDir The top level source directory, sources are relative to it
+ * @param workspaceInfo Workspace information
+ * @param buildtimeInclude Include directory of the devel or install space
+ * @param targets The target list to append to
+ */
+static void readTarget(const Utils::FilePath &file,
+                       const QDir &sourceDir,
+                       const ROSUtils::WorkspaceInfo &workspaceInfo,
+                       const QString &buildtimeInclude,
+                       ROSUtils::PackageTargetInfoList &targets)
+{
+    const QJsonObject target = readJsonObject(file);
+    const ROSUtils::TargetType type = targetType(target.value(QLatin1String("type")).toString());
+    if (type == ROSUtils::UtilityType)
+        return;
+
+    const QString name = target.value(QLatin1String("name")).toString();
+    const QString workspacePath = workspaceInfo.path.toString();
+    const QJsonArray sources = target.value(QLatin1String("sources")).toArray();
+    const QJsonArray compileGroups = target.value(QLatin1String("compileGroups")).toArray();
+    for (int i = 0; i < compileGroups.size(); ++i)
+    {
+        const QJsonObject group = compileGroups.at(i).toObject();
+        const QString language = group.value(QLatin1String("language")).toString();
+        if (language != QLatin1String("CXX") && language != QLatin1String("C"))
+            continue;
+
+        ROSUtils::PackageTargetInfoPtr targetInfo = std::make_shared<ROSUtils::PackageTargetInfo>();
+        targetInfo->name = (compileGroups.size() == 1) ? name : QString("%1 (%2)").arg(name).arg(i);
+        targetInfo->type = type;
+
+        for (const QJsonValue &fragment : group.value(QLatin1String("compileCommandFragments")).toArray())
+            targetInfo->flags.append(Utils::ProcessArgs::splitArgs(fragment.toObject().value(QLatin1String("fragment")).toString(),
+                                                                   Utils::HostOsInfo::hostOs()));
+
+        // The order matters so it will order local first then system
+        QStringList systemIncludes;
+        for (const QJsonValue &include : group.value(QLatin1String("includes")).toArray())
+        {
+            const QString path = include.toObject().value(QLatin1String("path")).toString();
+            QStringList &includes = path.startsWith(workspacePath) ? targetInfo->includes : systemIncludes;
+            if (!includes.contains(path))
+                includes.append(path);
+        }
+        targetInfo->includes.append(buildtimeInclude);
+        targetInfo->includes.append(systemIncludes);
+
+        for (const QJsonValue &define : group.value(QLatin1String("defines")).toArray())
+            targetInfo->defines.append(define.toObject().value(QLatin1String("define")).toString());
+
+        for (const QJsonValue &index : group.value(QLatin1String("sourceIndexes")).toArray())
+        {
+            const QString path = sources.at(index.toInt()).toObject().value(QLatin1String("path")).toString();
+            if (!path.isEmpty())
+                targetInfo->source_files.append(QDir::cleanPath(sourceDir.absoluteFilePath(path)));
+        }
+
+        targets.append(targetInfo);
+    }
+}
+
+Utils::FilePath ROSCMakeFileApi::cmakeBuildDirectory(const ROSUtils::WorkspaceInfo &workspaceInfo,
+                                                     const Utils::FilePath &packageBuildPath)
+{
+    if (workspaceInfo.buildSystem == ROSUtils::CatkinMake)
+        return workspaceInfo.buildPath;
+
+    return packageBuildPath;
+}
+
+bool ROSCMakeFileApi::writeQuery(const Utils::FilePath &cmakeBuildDirectory)
+{
+    const QString queryDir = cmakeBuildDirectory.pathAppended(QLatin1String(".cmake/api/v1/query")).pathAppended(QLatin1String(FILE_API_CLIENT)).toString();
+    const QString queryFile = queryDir + QLatin1Char('/') + QLatin1String(FILE_API_CODEMODEL);
+    if (QFile::exists(queryFile))
+        return true;
+
+    if (!QDir().mkpath(queryDir))
+        return false;
+
+    // A stateless query is an empty file named after the requested object kind
+    QFile file(queryFile);
+    return file.open(QFile::WriteOnly);
+}
+
+void ROSCMakeFileApi::writeQueries(const ROSUtils::WorkspaceInfo &workspaceInfo,
+                                   const ROSUtils::PackageInfoMap &packageInfo)
+{
+    if (workspaceInfo.buildSystem == ROSUtils::CatkinMake)
+    {
+        writeQuery(workspaceInfo.buildPath);
+        return;
+    }
+
+    for (const ROSUtils::PackageInfo &package : packageInfo)
+    {
+        if (package.metapackage || !package.buildFile.exists())
+            continue;
+
+        // Runs before every build, directories are only created inside existing build directories
+        Utils::FilePath packageBuildPath;
+        if (ROSUtils::findPackageBuildDirectory(workspaceInfo, package, packageBuildPath))
+            writeQuery(packageBuildPath);
+    }
+}
+
+Utils::FilePath ROSCMakeFileApi::codemodelReplyFile(const Utils::FilePath &cmakeBuildDirectory)
+{
+    const Utils::FilePath replyDir = cmakeBuildDirectory.pathAppended(QLatin1String(".cmake/api/v1/reply"));
+
+    // The index with the lexicographically largest name belongs to the latest run
+    const QStringList indexFiles = QDir(replyDir.toString()).entryList({QLatin1String("index-*.json")}, QDir::Files, QDir::Name);
+    if (indexFiles.isEmpty())
+        return Utils::FilePath();
+
+    const QJsonObject reply = readJsonObject(replyDir.pathAppended(indexFiles.last())).value(QLatin1String("reply")).toObject();
+
+    // Fall back to a shared query written by another tool, e.g. the CMake project manager
+    QJsonObject codemodel = reply.value(QLatin1String(FILE_API_CLIENT)).toObject().value(QLatin1String(FILE_API_CODEMODEL)).toObject();
+    if (!codemodel.contains(QLatin1String("jsonFile")))
+        codemodel = reply.value(QLatin1String(FILE_API_CODEMODEL)).toObject();
+
+    const QString jsonFile = codemodel.value(QLatin1String("jsonFile")).toString();
+    if (jsonFile.isEmpty())
+        return Utils::FilePath();
+
+    return replyDir.pathAppended(jsonFile);
+}
+
+ROSCMakeCodemodel ROSCMakeFileApi::readCodemodel(const Utils::FilePath &cmakeBuildDirectory,
+                                                 const QStringList &packagePaths)
+{
+    ROSCMakeCodemodel result;
+    const Utils::FilePath codemodelFile = codemodelReplyFile(cmakeBuildDirectory);
+    if (codemodelFile.isEmpty())
+        return result;
+
+    const QJsonObject codemodel = readJsonObject(codemodelFile);
+    const QJsonArray configurations = codemodel.value(QLatin1String("configurations")).toArray();
+    if (configurations.isEmpty())
+        return result;
+
+    result.file = codemodelFile;
+    result.sourceDirectory = codemodel.value(QLatin1String("paths")).toObject().value(QLatin1String("source")).toString();
+
+    QSet<QString> packages;
+    for (const QString &path : packagePaths)
+        packages.insert(QDir::cleanPath(path));
+
+    // Single configuration generators only have one configuration
+    const QJsonObject configuration = configurations.at(0).toObject();
+    const QJsonArray directories = configuration.value(QLatin1String("directories")).toArray();
+    const QDir sourceDir(result.sourceDirectory);
+    const Utils::FilePath replyDir = codemodelFile.parentDir();
+
+    // Far fewer directories than targets, each is only assigned to its package once
+    QStringList directoryPackages;
+    directoryPackages.reserve(directories.size());
+    for (const QJsonValue &directory : directories)
+    {
+        const QString source = directory.toObject().value(QLatin1String("source")).toString();
+        directoryPackages.append(packageOf(packages, QDir::cleanPath(sourceDir.absoluteFilePath(source))));
+    }
+
+    for (const QJsonValue &value : configuration.value(QLatin1String("targets")).toArray())
+    {
+        const QJsonObject target = value.toObject();
+        if (target.value(QLatin1String("name")).toString().startsWith(QLatin1String("gtest")))
+            continue;
+
+        const int directoryIndex = target.value(QLatin1String("directoryIndex")).toInt(-1);
+        if (directoryIndex < 0 || directoryIndex >= directoryPackages.size() || directoryPackages.at(directoryIndex).isEmpty())
+            continue;
+
+        result.packageTargets[directoryPackages.at(directoryIndex)].append(replyDir.pathAppended(target.value(QLatin1String("jsonFile")).toString()).toString());
+    }
+
+    return result;
+}
+
+bool ROSCMakeFileApi::readBuildInfo(const ROSUtils::WorkspaceInfo &workspaceInfo,
+                                    ROSUtils::PackageBuildInfo &buildInfo)
+{
+    const ROSCMakeCodemodel codemodel = readCodemodel(cmakeBuildDirectory(workspaceInfo, buildInfo.path), {buildInfo.parent.path.toString()});
+    return readBuildInfo(workspaceInfo, codemodel, buildInfo);
+}
+
+bool ROSCMakeFileApi::readBuildInfo(const ROSUtils::WorkspaceInfo &workspaceInfo,
+                                    const ROSCMakeCodemodel &codemodel,
+                                    ROSUtils::PackageBuildInfo &buildInfo)
+{
+    if (codemodel.file.isEmpty())
+        return false;
+
+    // build time include directory
+    Utils::FilePath buildtimeInclude(workspaceInfo.develPath);
+    if (workspaceInfo.install)
+        buildtimeInclude = Utils::FilePath(workspaceInfo.installPath);
+
+    buildtimeInclude = buildtimeInclude.pathAppended(QLatin1String("include"));
+
+    // make sure targets are cleared
+    buildInfo.targets.clear();
+
+    const QDir sourceDir(codemodel.sourceDirectory);
+    const QStringList targetFiles = codemodel.packageTargets.value(QDir::cleanPath(buildInfo.parent.path.toString()));
+    for (const QString &targetFile : targetFiles)
+        readTarget(Utils::FilePath::fromString(targetFile), sourceDir, workspaceInfo, buildtimeInclude.toString(), buildInfo.targets);
+
+    buildInfo.codemodelFile = codemodel.file;
+    return true;
+}
+
+} // namespace Internal
+} // namespace ROSProjectManager
@@ -0,0 +1,123 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ROS_CMAKE_FILE_API_H
+#define ROS_CMAKE_FILE_API_H
+
+#include "ros_utils.h"
+
+#include <QHash>
+#include <QStringList>
+
+namespace ROSProjectManager {
+namespace Internal {
+
+/** @brief A codemodel reply with its targets split by the package defining them */
+struct ROSCMakeCodemodel
+{
+    Utils::FilePath file;      /**< @brief The codemodel reply, empty if CMake did not answer the query */
+    QString sourceDirectory;   /**< @brief The top level source directory, target sources are relative to it */
+    QHash<QString, QStringList> packageTargets; /**< @brief Package source directory, target reply files */
+};
+
+/**
+ * @brief Reads package build information from the CMake File API (codemodel-v2).
+ *
+ * A stateless query is placed in the build directory of every package before CMake
+ * configures it, CMake then writes a reply describing every target with the exact
+ * compile flags, include directories, defines and sources of each compile group.
+ * Unlike the CodeBlocks project file this works with any generator.
+ *
+ * For catkin_make the whole workspace is a single CMake project, so the reply is read
+ * once and its targets are split by the package source directory they are defined in.
+ */
+class ROSCMakeFileApi
+{
+public:
+    /**
+     * @brief Get the top level CMake build directory of a package
+     * @param workspaceInfo Workspace information
+     * @param packageBuildPath The package's build directory
+     * @return The directory CMake writes its replies to
+     */
+    static Utils::FilePath cmakeBuildDirectory(const ROSUtils::WorkspaceInfo &workspaceInfo,
+                                               const Utils::FilePath &packageBuildPath);
+
+    /**
+     * @brief Write the codemodel query, the build directory is created if it does not exist
+     * @param cmakeBuildDirectory The top level CMake build directory
+     * @return True if the query exists, otherwise false
+     */
+    static bool writeQuery(const Utils::FilePath &cmakeBuildDirectory);
+
+    /**
+     * @brief Write the codemodel query for every package, must be called before the packages are configured.
+     *
+     * Only CMake packages whose build directory already exists get a query, packages configured
+     * for the first time get theirs when their build information is read after the build.
+     * May be called from any thread.
+     *
+     * @param workspaceInfo Workspace information
+     * @param packageInfo The workspace packages
+     */
+    static void writeQueries(const ROSUtils::WorkspaceInfo &workspaceInfo,
+                             const ROSUtils::PackageInfoMap &packageInfo);
+
+    /**
+     * @brief Get the codemodel reply of the latest CMake run
+     * @param cmakeBuildDirectory The top level CMake build directory
+     * @return Path to the codemodel reply, empty if CMake did not answer the query
+     */
+    static Utils::FilePath codemodelReplyFile(const Utils::FilePath &cmakeBuildDirectory);
+
+    /**
+     * @brief Read the codemodel reply of the latest CMake run
+     * @param cmakeBuildDirectory The top level CMake build directory
+     * @param packagePaths The source directories of the packages the targets are split by
+     * @return The codemodel, its file is empty if there is no reply
+     */
+    static ROSCMakeCodemodel readCodemodel(const Utils::FilePath &cmakeBuildDirectory,
+                                           const QStringList &packagePaths);
+
+    /**
+     * @brief Read the build information of a package from the codemodel reply
+     * @param workspaceInfo Workspace information
+     * @param buildInfo Package build information, path must be set
+     * @return True if a reply was found and read, otherwise false
+     */
+    static bool readBuildInfo(const ROSUtils::WorkspaceInfo &workspaceInfo,
+                              ROSUtils::PackageBuildInfo &buildInfo);
+
+    /**
+     * @brief Read the build information of a package from a codemodel that was already read
+     * @param workspaceInfo Workspace information
+     * @param codemodel The codemodel of the package's CMake build directory
+     * @param buildInfo Package build information, path must be set
+     * @return True if the codemodel has a reply, otherwise false
+     */
+    static bool readBuildInfo(const ROSUtils::WorkspaceInfo &workspaceInfo,
+                              const ROSCMakeCodemodel &codemodel,
+                              ROSUtils::PackageBuildInfo &buildInfo);
+};
+
+} // namespace Internal
+} // namespace ROSProjectManager
+
+#endif // ROS_CMAKE_FILE_API_H
@@ -19,6 +19,7 @@
  * limitations under the License.
  */
 #include "ros_colcon_step.h"
+#include "ros_cmake_file_api.h"
 #include "ros_project_constants.h"
 #include "ros_project.h"
 #include "ui_ros_colcon_step.h"
@@ -32,6 +33,7 @@
 #include <projectexplorer/projectexplorerconstants.h>
 #include <projectexplorer/toolchain.h>
 #include <qtsupport/qtparser.h>
+#include <utils/async.h>
 #include <utils/stringutils.h>
 #include <utils/qtcassert.h>
 #include <cmakeprojectmanager/cmakeparser.h>
@@ -54,7 +56,8 @@ const char ROS_COLCON_STEP_CMAKE_ARGUMENTS_KEY[] = "ROSProjectManager.ROSColconS
 const char ROS_COLCON_STEP_MAKE_ARGUMENTS_KEY[] = "ROSProjectManager.ROSColconStep.MakeArguments";
 
 ROSColconStep::ROSColconStep(BuildStepList *parent, const Utils::Id id) :
-    AbstractProcessStep(parent, id)
+    AbstractProcessStep(parent, id),
+    m_writingQueries(false)
 {
     setDefaultDisplayName(QCoreApplication::translate("ROSProjectManager::Internal::ROSColconStep",
                                                       ROS_COLCON_STEP_DISPLAY_NAME));
@@ -69,6 +72,17 @@ ROSColconStep::ROSColconStep(BuildStepList *parent, const Utils::Id id) :
         if (format == OutputFormat::Stdout)
             stdOutput(string);
     });
+
+    connect(&m_queryWatcher, &QFutureWatcher<void>::finished, this, [this]() {
+        m_writingQueries = false;
+        if (m_queryWatcher.isCanceled())
+        {
+            emit finished(false);
+            return;
+        }
+
+        AbstractProcessStep::doRun();
+    });
 }
 
 ROSBuildConfiguration *ROSColconStep::rosBuildConfiguration() const
@@ -117,6 +131,10 @@ bool ROSColconStep::init()
     pp->setEnvironment(env);
     pp->setCommandLine(makeCommand(allArguments(bc->cmakeBuildType())));
 
+    // CMake only answers File API queries that exist before it configures, they are written in doRun()
+    m_queryWorkspaceInfo = workspaceInfo;
+    m_queryPackageInfo = bc->project()->getPackageInfo();
+
     // If we are cleaning, then make can fail with an error code, but that doesn't mean
     // we should stop the clean queue
     // That is mostly so that rebuild works on an already clean project
@@ -125,6 +143,31 @@ bool ROSColconStep::init()
     return AbstractProcessStep::init();
 }
 
+void ROSColconStep::doRun()
+{
+    if (m_target != BUILD)
+    {
+        AbstractProcessStep::doRun();
+        return;
+    }
+
+    // Writing a query per package touches every build directory, which must not block the GUI thread
+    m_writingQueries = true;
+    m_queryWatcher.setFuture(Utils::asyncRun(ProjectExplorerPlugin::sharedThreadPool(), &ROSCMakeFileApi::writeQueries,
+                                             m_queryWorkspaceInfo, m_queryPackageInfo));
+}
+
+void ROSColconStep::doCancel()
+{
+    if (m_writingQueries)
+    {
+        m_queryWatcher.cancel();
+        return;
+    }
+
+    AbstractProcessStep::doCancel();
+}
+
 void ROSColconStep::setupOutputFormatter(Utils::OutputFormatter *formatter)
 {
     formatter->addLineParser(new GnuMakeParser);
@@ -176,9 +219,9 @@ QString ROSColconStep::allArguments(ROSUtils::BuildType buildType, bool includeD
         args << "--event-handlers status+ console_start_end+";
         if (includeDefault)
             if (buildType == ROSUtils::BuildTypeUserDefined)
-                args << QString("--cmake-args -G \"CodeBlocks - Unix Makefiles\" %1").arg(m_cmakeArguments);
+                args << QString("--cmake-args %1 %2").arg(ROSUtils::getCMakeGeneratorArgument(m_cmakeArguments, buildEnvironment()), m_cmakeArguments);
             else
-                args << QString("--cmake-args -G \"CodeBlocks - Unix Makefiles\" %1 %2").arg(ROSUtils::getCMakeBuildTypeArgument(buildType), m_cmakeArguments);
+                args << QString("--cmake-args %1 %2 %3").arg(ROSUtils::getCMakeGeneratorArgument(m_cmakeArguments, buildEnvironment()), ROSUtils::getCMakeBuildTypeArgument(buildType), m_cmakeArguments);
         else
             if (!m_cmakeArguments.isEmpty())
                 args << QString("--cmake-args %1").arg(m_cmakeArguments);
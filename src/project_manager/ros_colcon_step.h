@@ -24,6 +24,8 @@
 #include <projectexplorer/abstractprocessstep.h>
 #include "ros_build_configuration.h"
 
+#include <QFutureWatcher>
+
 QT_BEGIN_NAMESPACE
 class QListWidgetItem;
 QT_END_NAMESPACE
@@ -66,6 +68,8 @@ protected:
     QStringList automaticallyAddedArguments() const;
     void fromMap(const Utils::Store &map) override;
     QWidget *createConfigWidget() override;
+    void doRun() override;
+    void doCancel() override;
 
 private:
     ROSBuildConfiguration *targetsActiveBuildConfiguration() const;
@@ -76,6 +80,12 @@ private:
     QString m_cmakeArguments;
     QString m_makeArguments;
     QRegularExpression m_percentProgress;
+
+    // The File API queries are written on a worker thread before the build process starts
+    ROSUtils::WorkspaceInfo m_queryWorkspaceInfo;
+    ROSUtils::PackageInfoMap m_queryPackageInfo;
+    QFutureWatcher<void> m_queryWatcher;
+    bool m_writingQueries;
 };
 
 class ROSColconStepWidget : public QWidget
@@ -0,0 +1,481 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ros_compile_commands.h"
+#include "ros_cmake_file_api.h"
+
+#include <utils/hostosinfo.h>
+#include <utils/processargs.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QRegularExpression>
+
+namespace ROSProjectManager {
+namespace Internal {
+
+/**
+ * @brief Pull parser for the array of flat objects a compilation database consists of.
+ *
+ * Only the members of an entry are decoded, unknown members are skipped without
+ * allocating anything.
+ */
+class CompileCommandsParser
+{
+public:
+    CompileCommandsParser(const char *begin, const char *end) :
+        m_pos(begin),
+        m_end(end)
+    {
+    }
+
+    /** @brief Consume the opening bracket of the database */
+    bool begin()
+    {
+        skipWhitespace();
+        return consume('[');
+    }
+
+    /**
+     * @brief Read the next entry
+     * @param command The entry
+     * @return False at the end of the database or on a syntax error
+     */
+    bool next(ROSCompileCommands::CompileCommand &command)
+    {
+        skipWhitespace();
+        if (m_pos < m_end && *m_pos == ']')
+        {
+            ++m_pos;
+            m_finished = true;
+            return false;
+        }
+
+        if (m_entries > 0 && !consume(','))
+            return false;
+
+        command = ROSCompileCommands::CompileCommand();
+        if (!consume('{'))
+            return false;
+
+        QString key;
+        bool first = true;
+        while (true)
+        {
+            if (consume('}'))
+                break;
+
+            if ((!first && !consume(',')) || !parseString(key) || !consume(':'))
+                return false;
+
+            first = false;
+            bool ok = true;
+            if (key == QLatin1String("directory"))
+                ok = parseString(command.directory);
+            else if (key == QLatin1String("file"))
+                ok = parseString(command.file);
+            else if (key == QLatin1String("output"))
+                ok = parseString(command.output);
+            else if (key == QLatin1String("arguments"))
+                ok = parseStringArray(command.arguments);
+            else if (key == QLatin1String("command"))
+            {
+                QString line;
+                ok = parseString(line);
+                command.arguments = Utils::ProcessArgs::splitArgs(line, Utils::HostOsInfo::hostOs());
+            }
+            else
+                ok = skipValue(0);
+
+            if (!ok)
+                return false;
+        }
+
+        ++m_entries;
+        return true;
+    }
+
+    /** @brief True if the closing bracket of the database was reached */
+    bool isFinished() const { return m_finished; }
+
+private:
+    void skipWhitespace()
+    {
+        while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\n' || *m_pos == '\r' || *m_pos == '\t'))
+            ++m_pos;
+    }
+
+    bool consume(char c)
+    {
+        skipWhitespace();
+        if (m_pos >= m_end || *m_pos != c)
+            return false;
+
+        ++m_pos;
+        return true;
+    }
+
+    bool parseHex4(char16_t &value)
+    {
+        if (m_end - m_pos < 4)
+            return false;
+
+        value = 0;
+        for (int i = 0; i < 4; ++i, ++m_pos)
+        {
+            const char c = *m_pos;
+            value <<= 4;
+            if (c >= '0' && c <= '9')
+                value |= c - '0';
+            else if (c >= 'a' && c <= 'f')
+                value |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F')
+                value |= c - 'A' + 10;
+            else
+                return false;
+        }
+        return true;
+    }
+
+    bool parseString(QString &value)
+    {
+        if (!consume('"'))
+            return false;
+
+        // Most strings have no escapes and are converted directly from the mapped file
+        const char *start = m_pos;
+        while (m_pos < m_end && *m_pos != '"' && *m_pos != '\\')
+            ++m_pos;
+
+        if (m_pos < m_end && *m_pos == '"')
+        {
+            value = QString::fromUtf8(start, m_pos - start);
+            ++m_pos;
+            return true;
+        }
+
+        QByteArray utf8(start, m_pos - start);
+        while (m_pos < m_end && *m_pos != '"')
+        {
+            if (*m_pos != '\\')
+            {
+                utf8.append(*m_pos++);
+                continue;
+            }
+
+            if (++m_pos >= m_end)
+                return false;
+
+            switch (*m_pos++)
+            {
+            case '"': utf8.append('"'); break;
+            case '\\': utf8.append('\\'); break;
+            case '/': utf8.append('/'); break;
+            case 'b': utf8.append('\b'); break;
+            case 'f': utf8.append('\f'); break;
+            case 'n': utf8.append('\n'); break;
+            case 'r': utf8.append('\r'); break;
+            case 't': utf8.append('\t'); break;
+            case 'u':
+            {
+                char16_t units[2];
+                qsizetype count = 1;
+                if (!parseHex4(units[0]))
+                    return false;
+
+                // Characters outside the BMP are escaped as a surrogate pair
+                if (QChar::isHighSurrogate(units[0]) && m_end - m_pos >= 6 && m_pos[0] == '\\' && m_pos[1] == 'u')
+                {
+                    m_pos += 2;
+                    if (!parseHex4(units[1]))
+                        return false;
+
+                    count = 2;
+                }
+                utf8.append(QStringView(units, count).toUtf8());
+                break;
+            }
+            default:
+                return false;
+            }
+        }
+
+        if (m_pos >= m_end)
+            return false;
+
+        ++m_pos;
+        value = QString::fromUtf8(utf8);
+        return true;
+    }
+
+    bool parseStringArray(QStringList &values)
+    {
+        values.clear();
+        if (!consume('['))
+            return false;
+
+        if (consume(']'))
+            return true;
+
+        do
+        {
+            QString value;
+            if (!parseString(value))
+                return false;
+
+            values.append(value);
+        } while (consume(','));
+
+        return consume(']');
+    }
+
+    bool skipValue(int depth)
+    {
+        // Entries are flat, anything nested this deep is not a compilation database
+        if (depth > 32)
+            return false;
+
+        skipWhitespace();
+        if (m_pos >= m_end)
+            return false;
+
+        switch (*m_pos)
+        {
+        case '"':
+        {
+            QString ignored;
+            return parseString(ignored);
+        }
+        case '[':
+        case '{':
+        {
+            const char close = (*m_pos == '[') ? ']' : '}';
+            ++m_pos;
+            if (consume(close))
+                return true;
+
+            do
+            {
+                if (close == '}')
+                {
+                    QString ignored;
+                    if (!parseString(ignored) || !consume(':'))
+                        return false;
+                }
+
+                if (!skipValue(depth + 1))
+                    return false;
+            } while (consume(','));
+
+            return consume(close);
+        }
+        default:
+            // Numbers, true, false and null
+            while (m_pos < m_end && *m_pos != ',' && *m_pos != '}' && *m_pos != ']'
+                   && *m_pos != ' ' && *m_pos != '\n' && *m_pos != '\r' && *m_pos != '\t')
+                ++m_pos;
+
+            return true;
+        }
+    }
+
+    const char *m_pos;
+    const char *m_end;
+    int m_entries = 0;
+    bool m_finished = false;
+};
+
+/** @brief The include paths, defines and remaining flags of a compile command */
+struct CompileArguments
+{
+    QStringList flags;
+    QStringList localIncludes;
+    QStringList systemIncludes;
+    QStringList defines;
+};
+
+/**
+ * @brief Split a compile command into include paths, defines and flags
+ *
+ * The compiler, the source file and the output and dependency file options are dropped
+ * so that files compiled with the same options end up with equal arguments.
+ */
+static CompileArguments splitCompileArguments(const ROSCompileCommands::CompileCommand &command,
+                                              const QString &workspacePath)
+{
+    CompileArguments result;
+    const QDir directory(command.directory);
+    const auto addInclude = [&](const QString &path, bool system) {
+        const QString include = QDir::cleanPath(directory.absoluteFilePath(path));
+        QStringList &includes = (!system && include.startsWith(workspacePath)) ? result.localIncludes : result.systemIncludes;
+        if (!includes.contains(include))
+            includes.append(include);
+    };
+
+    const QStringList &args = command.arguments;
+    for (int i = 1; i < args.size(); ++i)
+    {
+        const QString &arg = args.at(i);
+        const bool hasNext = (i + 1 < args.size());
+        if (arg == QLatin1String("-c") || arg == command.file
+            || arg == QLatin1String("-MD") || arg == QLatin1String("-MMD") || arg == QLatin1String("-MP"))
+            continue;
+
+        if (arg == QLatin1String("-o") || arg == QLatin1String("-MF") || arg == QLatin1String("-MT") || arg == QLatin1String("-MQ"))
+            ++i;
+        else if (arg == QLatin1String("-I") && hasNext)
+            addInclude(args.at(++i), false);
+        else if (arg.startsWith(QLatin1String("-I")))
+            addInclude(arg.mid(2), false);
+        else if (arg == QLatin1String("-iquote") && hasNext)
+            addInclude(args.at(++i), false);
+        else if (arg == QLatin1String("-isystem") && hasNext)
+            addInclude(args.at(++i), true);
+        else if (arg.startsWith(QLatin1String("-isystem")))
+            addInclude(arg.mid(8), true);
+        else if (arg == QLatin1String("-D") && hasNext)
+            result.defines.append(args.at(++i));
+        else if (arg.startsWith(QLatin1String("-D")))
+            result.defines.append(arg.mid(2));
+        else
+            result.flags.append(arg);
+    }
+
+    return result;
+}
+
+/** @brief Get the CMake target an object file belongs to */
+static QString targetName(const ROSCompileCommands::CompileCommand &command)
+{
+    static const QRegularExpression targetDirectory(QLatin1String("CMakeFiles/([^/]+)\\.dir/"));
+
+    QString output = command.output;
+    if (output.isEmpty())
+    {
+        const int index = static_cast<int>(command.arguments.indexOf(QLatin1String("-o")));
+        if (index >= 0 && index + 1 < command.arguments.size())
+            output = command.arguments.at(index + 1);
+    }
+
+    const QRegularExpressionMatch match = targetDirectory.match(output);
+    if (match.hasMatch())
+        return match.captured(1);
+
+    return QFileInfo(command.file).completeBaseName();
+}
+
+bool ROSCompileCommands::read(const Utils::FilePath &file, const EntryFunction &entry)
+{
+    QFile database(file.toString());
+    if (!database.open(QFile::ReadOnly) || database.size() == 0)
+        return false;
+
+    // Mapping avoids copying the database, files that can not be mapped are read instead
+    QByteArray content;
+    const char *begin = reinterpret_cast<const char *>(database.map(0, database.size()));
+    const char *end = begin + database.size();
+    if (!begin)
+    {
+        content = database.readAll();
+        begin = content.constData();
+        end = begin + content.size();
+    }
+
+    CompileCommandsParser parser(begin, end);
+    if (!parser.begin())
+        return false;
+
+    CompileCommand command;
+    while (parser.next(command))
+    {
+        if (!entry(command))
+            return false;
+    }
+
+    return parser.isFinished();
+}
+
+bool ROSCompileCommands::readBuildInfo(const ROSUtils::WorkspaceInfo &workspaceInfo,
+                                       ROSUtils::PackageBuildInfo &buildInfo)
+{
+    if (workspaceInfo.buildSystem == ROSUtils::CatkinMake)
+        return false;
+
+    const Utils::FilePath databaseFile = ROSCMakeFileApi::cmakeBuildDirectory(workspaceInfo, buildInfo.path).pathAppended(QLatin1String("compile_commands.json"));
+    if (!databaseFile.exists())
+        return false;
+
+    // build time include directory
+    Utils::FilePath buildtimeInclude(workspaceInfo.develPath);
+    if (workspaceInfo.install)
+        buildtimeInclude = Utils::FilePath(workspaceInfo.installPath);
+
+    buildtimeInclude = buildtimeInclude.pathAppended(QLatin1String("include"));
+
+    const QString workspacePath = workspaceInfo.path.toString();
+    ROSUtils::PackageTargetInfoList targets;
+    QHash<QString, ROSUtils::PackageTargetInfoPtr> groups; // Target info by target name and arguments
+    QHash<QString, int> targetGroupCount;
+
+    const bool ok = read(databaseFile, [&](const CompileCommand &command) {
+        const QString name = targetName(command);
+        if (name.startsWith(QLatin1String("gtest")))
+            return true;
+
+        const CompileArguments args = splitCompileArguments(command, workspacePath);
+        const QString key = name + QLatin1Char('\n') + args.flags.join(QLatin1Char(' ')) + QLatin1Char('\n')
+                            + args.localIncludes.join(QLatin1Char(' ')) + QLatin1Char('\n')
+                            + args.systemIncludes.join(QLatin1Char(' ')) + QLatin1Char('\n')
+                            + args.defines.join(QLatin1Char(' '));
+
+        ROSUtils::PackageTargetInfoPtr &targetInfo = groups[key];
+        if (!targetInfo)
+        {
+            // Files of a target compiled with different options are split into numbered groups
+            const int count = targetGroupCount[name]++;
+            targetInfo = std::make_shared<ROSUtils::PackageTargetInfo>();
+            targetInfo->name = (count == 0) ? name : QString("%1 (%2)").arg(name).arg(count);
+            targetInfo->type = ROSUtils::ExecutableType; // The database does not record the target type
+            targetInfo->flags = args.flags;
+            targetInfo->defines = args.defines;
+
+            // The order matters so it will order local first then system
+            targetInfo->includes = args.localIncludes;
+            targetInfo->includes.append(buildtimeInclude.toString());
+            targetInfo->includes.append(args.systemIncludes);
+            targets.append(targetInfo);
+        }
+
+        targetInfo->source_files.append(QDir::cleanPath(QDir(command.directory).absoluteFilePath(command.file)));
+        return true;
+    });
+
+    if (!ok)
+        return false;
+
+    buildInfo.targets = targets;
+    buildInfo.compileCommandsFile = databaseFile;
+    return true;
+}
+
+} // namespace Internal
+} // namespace ROSProjectManager
@@ -0,0 +1,81 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ROS_COMPILE_COMMANDS_H
+#define ROS_COMPILE_COMMANDS_H
+
+#include "ros_utils.h"
+
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+
+namespace ROSProjectManager {
+namespace Internal {
+
+/**
+ * @brief Reads package build information from a JSON compilation database.
+ *
+ * CMake writes compile_commands.json when CMAKE_EXPORT_COMPILE_COMMANDS is enabled. The
+ * database is memory mapped and read one entry at a time, so even very large databases
+ * are never held as a QJsonDocument. Entries with the same arguments are grouped into one
+ * PackageTargetInfo named after the CMake target producing the object file, so every file
+ * keeps its exact flags.
+ *
+ * Only used for build systems configuring every package separately, the database of
+ * catkin_make covers the whole workspace and is served by the CMake File API instead.
+ */
+class ROSCompileCommands
+{
+public:
+    /** @brief A single entry of the compilation database */
+    struct CompileCommand {
+        QString directory;     /**< @brief Working directory of the compiler */
+        QString file;          /**< @brief The source file */
+        QString output;        /**< @brief The output file, may be empty */
+        QStringList arguments; /**< @brief The command line, the first argument is the compiler */
+    };
+
+    /** @brief Called for every entry, returns false to stop reading */
+    using EntryFunction = std::function<bool(const CompileCommand &command)>;
+
+    /**
+     * @brief Read a compilation database entry by entry
+     * @param file Path to the compilation database
+     * @param entry Called for every entry
+     * @return True if the whole database was read, otherwise false
+     */
+    static bool read(const Utils::FilePath &file, const EntryFunction &entry);
+
+    /**
+     * @brief Read the build information of a package from its compilation database
+     * @param workspaceInfo Workspace information
+     * @param buildInfo Package build information, path must be set
+     * @return True if a database was found and read, otherwise false
+     */
+    static bool readBuildInfo(const ROSUtils::WorkspaceInfo &workspaceInfo,
+                              ROSUtils::PackageBuildInfo &buildInfo);
+};
+
+} // namespace Internal
+} // namespace ROSProjectManager
+
+#endif // ROS_COMPILE_COMMANDS_H
@@ -0,0 +1,415 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ros_directory_walker.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPair>
+#include <QSemaphore>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+namespace ROSProjectManager {
+namespace Internal {
+
+#ifdef Q_OS_UNIX
+/** @brief Device and inode of a directory */
+typedef QPair<quint64, quint64> DirectoryId;
+#else
+/** @brief Canonical path of a directory, a hash of it could collide */
+typedef QString DirectoryId;
+#endif
+
+/** @brief The directories from the root down to a directory, used to detect loops */
+struct DirectoryAncestor
+{
+    DirectoryId id;
+    std::shared_ptr<const DirectoryAncestor> parent;
+};
+
+/**
+ * @brief Get the identity of a directory
+ * @param path Path to the directory
+ * @param id The device and inode of the directory a symbolic link points to
+ * @param isLink Set to true if path is a symbolic link
+ * @return False if the directory does not exist
+ */
+static bool directoryId(const QString &path, DirectoryId &id, bool &isLink)
+{
+#ifdef Q_OS_UNIX
+    const QByteArray encoded = QFile::encodeName(path);
+    struct stat st;
+    if (::lstat(encoded.constData(), &st) != 0)
+        return false;
+
+    isLink = S_ISLNK(st.st_mode);
+    if (isLink && ::stat(encoded.constData(), &st) != 0)
+        return false;
+
+    id = DirectoryId(static_cast<quint64>(st.st_dev), static_cast<quint64>(st.st_ino));
+    return true;
+#else
+    // Without inodes the canonical path identifies the directory
+    const QFileInfo info(path);
+    const QString canonical = info.canonicalFilePath();
+    if (canonical.isEmpty())
+        return false;
+
+    isLink = info.isSymLink();
+    id = canonical;
+    return true;
+#endif
+}
+
+/** @brief The path a directory was entered through, only used by SymlinkPolicy::FollowOnce */
+struct VisitedPath
+{
+    QString path;
+    bool linked; /**< @brief The path passes through a symbolic link */
+};
+
+/**
+ * @brief Check if a path is preferred over another path to the same directory
+ *
+ * Paths without symbolic links are preferred, otherwise the smaller path compared component
+ * by component. The order carries over to subdirectories, so the choice does not depend on
+ * which path a worker reached first.
+ */
+static bool isPreferredPath(const QString &path, bool linked, const VisitedPath &other)
+{
+    if (linked != other.linked)
+        return !linked;
+
+    const int size = static_cast<int>(qMin(path.size(), other.path.size()));
+    for (int i = 0; i < size; ++i)
+    {
+        const QChar a = path.at(i);
+        const QChar b = other.path.at(i);
+        if (a == b)
+            continue;
+
+        // The separator sorts before every other character
+        if (a == QLatin1Char('/'))
+            return true;
+
+        if (b == QLatin1Char('/'))
+            return false;
+
+        return a < b;
+    }
+
+    return path.size() < other.path.size();
+}
+
+struct ROSDirectoryWalker::WorkItem
+{
+    QString directory;
+    ROSPathFilter::ScopePtr scope; /**< @brief Scope of the parent directory */
+    std::shared_ptr<const DirectoryAncestor> ancestors; /**< @brief Only used by SymlinkPolicy::FollowLoopSafe */
+    bool linked = false; /**< @brief The path passes through a symbolic link */
+};
+
+struct ROSDirectoryWalker::WorkQueue
+{
+    QMutex mutex;
+    std::deque<WorkItem> items;
+};
+
+struct ROSDirectoryWalker::WalkState
+{
+    explicit WalkState(int count) :
+        queueCount(count),
+        queues(new WorkQueue[count]),
+        results(count)
+    {
+    }
+
+    const int queueCount;
+    std::unique_ptr<WorkQueue[]> queues;
+    std::vector<QHash<QString, ROSUtils::FolderContent>> results; /**< @brief Results of each worker */
+    std::atomic<int> pending{0}; /**< @brief Directories queued or being read */
+    std::atomic<int> queued{0};  /**< @brief Directories queued, not yet taken by a worker */
+    QMutex idleMutex;
+    QWaitCondition idleCondition; /**< @brief Signaled when directories are queued or the walk is done */
+    QMutex visitedMutex;
+    QHash<DirectoryId, VisitedPath> visited; /**< @brief Only used by SymlinkPolicy::FollowOnce */
+    QSet<QString> superseded;                /**< @brief Paths not kept because a preferred path leads to the same directory */
+};
+
+ROSDirectoryWalker::ROSDirectoryWalker(const ReadFunction &read) :
+    m_read(read),
+    m_symlinkPolicy(SymlinkPolicy::FollowOnce),
+    m_pool(nullptr),
+    m_maxThreadCount(QThread::idealThreadCount())
+{
+}
+
+void ROSDirectoryWalker::setSymlinkPolicy(SymlinkPolicy policy)
+{
+    m_symlinkPolicy = policy;
+}
+
+void ROSDirectoryWalker::setEnterFunction(const EnterFunction &enter)
+{
+    m_enter = enter;
+}
+
+void ROSDirectoryWalker::setCanceledFunction(const CanceledFunction &canceled)
+{
+    m_canceled = canceled;
+}
+
+void ROSDirectoryWalker::setThreadPool(QThreadPool *pool)
+{
+    m_pool = pool;
+}
+
+void ROSDirectoryWalker::setMaxThreadCount(int count)
+{
+    m_maxThreadCount = qMax(1, count);
+}
+
+QHash<QString, ROSUtils::FolderContent> ROSDirectoryWalker::walk(const QString &root, const ROSPathFilter::ScopePtr &scope) const
+{
+    WalkState state(m_maxThreadCount);
+    state.pending = 1;
+    state.queued = 1;
+
+    WorkItem item{root, scope, nullptr, false};
+    DirectoryId id;
+    bool isLink = false;
+    if (directoryId(root, id, isLink))
+    {
+        if (m_symlinkPolicy == SymlinkPolicy::FollowOnce)
+            state.visited.insert(id, {root, false});
+        else if (m_symlinkPolicy == SymlinkPolicy::FollowLoopSafe)
+            item.ancestors = std::make_shared<const DirectoryAncestor>(DirectoryAncestor{id, nullptr});
+    }
+    state.queues[0].items.push_back(std::move(item));
+
+    // Only start helpers on idle threads, the calling thread guarantees progress on its own
+    QThreadPool *pool = m_pool ? m_pool : QThreadPool::globalInstance();
+    QSemaphore finished;
+    int started = 0;
+    for (int i = 1; i < state.queueCount; ++i)
+    {
+        if (pool->tryStart([this, &state, &finished, i]() { work(state, i); finished.release(); }))
+            ++started;
+    }
+
+    work(state, 0);
+    finished.acquire(started);
+
+    QHash<QString, ROSUtils::FolderContent> content = std::move(state.results[0]);
+    for (int i = 1; i < state.queueCount; ++i)
+        content.insert(state.results[i]);
+
+    // Subtrees read through a path that was later replaced are dropped
+    if (!state.superseded.isEmpty())
+    {
+        content.removeIf([&state](const QHash<QString, ROSUtils::FolderContent>::iterator it) {
+            for (QString path = it.key(); !path.isEmpty(); path.truncate(path.lastIndexOf(QLatin1Char('/'))))
+            {
+                if (state.superseded.contains(path))
+                    return true;
+            }
+            return false;
+        });
+
+        // The directory is only listed under the path it is kept under
+        for (const QString &path : std::as_const(state.superseded))
+        {
+            const int separator = path.lastIndexOf(QLatin1Char('/'));
+            auto parent = content.find(path.left(separator));
+            if (parent != content.end())
+                parent.value().directories.removeOne(path.mid(separator + 1));
+        }
+    }
+
+    return content;
+}
+
+bool ROSDirectoryWalker::enter(WalkState &state, const WorkItem &parent, const QString &directory, WorkItem &child) const
+{
+    DirectoryId id;
+    bool isLink = false;
+    if (!directoryId(directory, id, isLink))
+        return false;
+
+    child.linked = parent.linked || isLink;
+    switch (m_symlinkPolicy)
+    {
+    case SymlinkPolicy::Ignore:
+        if (isLink)
+            return false;
+        break;
+    case SymlinkPolicy::FollowOnce:
+    {
+        // Catches loops as well as several links to the same directory, the preferred path wins
+        // regardless of the order in which the workers reach the directory
+        QMutexLocker locker(&state.visitedMutex);
+        auto it = state.visited.find(id);
+        if (it != state.visited.end())
+        {
+            if (!isPreferredPath(directory, child.linked, it.value()))
+            {
+                state.superseded.insert(directory);
+                return false;
+            }
+
+            state.superseded.insert(it.value().path);
+            it.value() = {directory, child.linked};
+            break;
+        }
+
+        state.visited.insert(id, {directory, child.linked});
+        break;
+    }
+    case SymlinkPolicy::FollowLoopSafe:
+        for (const DirectoryAncestor *ancestor = parent.ancestors.get(); ancestor; ancestor = ancestor->parent.get())
+        {
+            if (ancestor->id == id)
+                return false;
+        }
+
+        child.ancestors = std::make_shared<const DirectoryAncestor>(DirectoryAncestor{id, parent.ancestors});
+        break;
+    }
+
+    if (m_enter && !m_enter(directory))
+        return false;
+
+    child.directory = directory;
+    return true;
+}
+
+bool ROSDirectoryWalker::take(WalkState &state, int index, WorkItem &item) const
+{
+    // Own queue is processed depth first to keep the directory working set small
+    {
+        WorkQueue &own = state.queues[index];
+        QMutexLocker locker(&own.mutex);
+        if (!own.items.empty())
+        {
+            item = std::move(own.items.back());
+            own.items.pop_back();
+            --state.queued;
+            return true;
+        }
+    }
+
+    // Steal the oldest entry of another worker, it is closest to the root
+    for (int i = 1; i < state.queueCount; ++i)
+    {
+        WorkQueue &victim = state.queues[(index + i) % state.queueCount];
+        QMutexLocker locker(&victim.mutex);
+        if (!victim.items.empty())
+        {
+            item = std::move(victim.items.front());
+            victim.items.pop_front();
+            --state.queued;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ROSDirectoryWalker::wake(WalkState &state) const
+{
+    // Taking the mutex orders the wake after a worker that is about to wait has checked the counters
+    QMutexLocker locker(&state.idleMutex);
+    state.idleCondition.wakeAll();
+}
+
+void ROSDirectoryWalker::work(WalkState &state, int index) const
+{
+    WorkItem item;
+    while (true)
+    {
+        // Queued directories are abandoned, every worker stops at its next directory
+        if (m_canceled && m_canceled())
+        {
+            wake(state);
+            return;
+        }
+
+        if (!take(state, index, item))
+        {
+            // Other workers may still discover new directories, sleep until they queue some
+            QMutexLocker locker(&state.idleMutex);
+            if (state.pending.load() == 0)
+                return;
+
+            // The timeout only bounds how late a canceled walk is noticed
+            if (state.queued.load() == 0)
+                state.idleCondition.wait(&state.idleMutex, 100);
+
+            continue;
+        }
+
+        ROSPathFilter::ScopePtr scope = std::move(item.scope);
+        ROSUtils::FolderContent content = m_read(item.directory, scope);
+
+        std::vector<WorkItem> subDirectories;
+        subDirectories.reserve(content.directories.size());
+        for (const QString &name : std::as_const(content.directories))
+        {
+            WorkItem child{QString(), scope, nullptr, false};
+            if (enter(state, item, item.directory + QLatin1Char('/') + name, child))
+                subDirectories.push_back(std::move(child));
+        }
+
+        if (!subDirectories.empty())
+        {
+            // Children are accounted for before the parent is marked done
+            state.pending += static_cast<int>(subDirectories.size());
+            WorkQueue &own = state.queues[index];
+            QMutexLocker locker(&own.mutex);
+            for (WorkItem &child : subDirectories)
+                own.items.push_back(std::move(child));
+
+            state.queued += static_cast<int>(subDirectories.size());
+            locker.unlock();
+            wake(state);
+        }
+
+        state.results[index].insert(item.directory, std::move(content));
+        if (--state.pending == 0)
+            wake(state);
+    }
+}
+
+} // namespace Internal
+} // namespace ROSProjectManager
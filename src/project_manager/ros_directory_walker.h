@@ -0,0 +1,143 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ROS_DIRECTORY_WALKER_H
+#define ROS_DIRECTORY_WALKER_H
+
+#include "ros_utils.h"
+#include "ros_path_filter.h"
+
+#include <QHash>
+#include <QString>
+
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+class QThreadPool;
+QT_END_NAMESPACE
+
+namespace ROSProjectManager {
+namespace Internal {
+
+/**
+ * @brief Parallel recursive directory walker.
+ *
+ * Each directory is read exactly once. Every worker owns a queue of directories it
+ * discovered and processes it depth first, idle workers steal the oldest entries
+ * (the largest remaining subtrees) from the other workers. The calling thread always
+ * takes part in the walk, additional workers are only started if the thread pool
+ * has idle threads, so the walk can not dead lock when called from a pool thread.
+ * Workers without work sleep until another worker queues directories or the walk is done.
+ *
+ * Directories are identified by device and inode, or by canonical path where there are no
+ * inodes, so symbolic links can neither make the walk loop nor read the same directory twice,
+ * depending on the SymlinkPolicy.
+ */
+class ROSDirectoryWalker
+{
+public:
+    /** @brief How symbolic links to directories are handled */
+    enum class SymlinkPolicy
+    {
+        Ignore,         /**< @brief Symbolic links to directories are not entered */
+        FollowOnce,     /**< @brief Every physical directory is kept and listed once, under the path without symbolic links or the smallest path */
+        FollowLoopSafe  /**< @brief Links are entered unless they lead back to a directory above them */
+    };
+
+    /**
+     * @brief Reads a directory and returns its content, called concurrently.
+     *
+     * The scope holds the .gitignore rules of the parent directory and may be replaced
+     * with the scope of the directory, which is then handed to its subdirectories.
+     */
+    using ReadFunction = std::function<ROSUtils::FolderContent(const QString &directory, ROSPathFilter::ScopePtr &scope)>;
+
+    /** @brief Returns true if a subdirectory should be entered, called concurrently */
+    using EnterFunction = std::function<bool(const QString &directory)>;
+
+    /** @brief Returns true if the walk should stop, called concurrently */
+    using CanceledFunction = std::function<bool()>;
+
+    /**
+     * @brief Constructor
+     * @param read Function used to read each directory
+     */
+    explicit ROSDirectoryWalker(const ReadFunction &read);
+
+    /**
+     * @brief Set the function deciding which subdirectories are entered, by default all are entered
+     * @param enter The enter function
+     */
+    void setEnterFunction(const EnterFunction &enter);
+
+    /**
+     * @brief Set how symbolic links to directories are handled, by default FollowOnce
+     * @param policy The symbolic link policy
+     */
+    void setSymlinkPolicy(SymlinkPolicy policy);
+
+    /**
+     * @brief Set the function checked before each directory is read, a canceled walk returns the directories read so far
+     * @param canceled The canceled function
+     */
+    void setCanceledFunction(const CanceledFunction &canceled);
+
+    /**
+     * @brief Set the thread pool the additional workers are started on
+     * @param pool The thread pool, if nullptr the global thread pool is used
+     */
+    void setThreadPool(QThreadPool *pool);
+
+    /**
+     * @brief Set the maximum number of threads, including the calling thread
+     * @param count The thread count
+     */
+    void setMaxThreadCount(int count);
+
+    /**
+     * @brief Walk the directory tree
+     * @param root The directory to start from
+     * @param scope The .gitignore scope of the parent of root
+     * @return QHash<QString, FolderContent> Directory, FolderContent for every visited directory
+     */
+    QHash<QString, ROSUtils::FolderContent> walk(const QString &root, const ROSPathFilter::ScopePtr &scope = ROSPathFilter::ScopePtr()) const;
+
+private:
+    struct WorkItem;
+    struct WorkQueue;
+    struct WalkState;
+
+    bool enter(WalkState &state, const WorkItem &parent, const QString &directory, WorkItem &child) const;
+    void work(WalkState &state, int index) const;
+    bool take(WalkState &state, int index, WorkItem &item) const;
+    void wake(WalkState &state) const;
+
+    ReadFunction m_read;
+    EnterFunction m_enter;
+    CanceledFunction m_canceled;
+    SymlinkPolicy m_symlinkPolicy;
+    QThreadPool *m_pool;
+    int m_maxThreadCount;
+};
+
+} // namespace Internal
+} // namespace ROSProjectManager
+
+#endif // ROS_DIRECTORY_WALKER_H
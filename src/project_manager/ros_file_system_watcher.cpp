@@ -0,0 +1,573 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ros_file_system_watcher.h"
+
+#include <coreplugin/messagemanager.h>
+#include <utils/algorithm.h>
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QMap>
+#include <QMultiHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+
+#include <atomic>
+
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace ROSProjectManager {
+namespace Internal {
+
+// Default time without new events before a batch is delivered
+static const int COALESCE_INTERVAL = 100;
+
+// A batch is delivered at the latest after this time even if events keep arriving
+static const int COALESCE_MAX_LATENCY = 1000;
+
+class ROSFileSystemWatcher::Backend
+{
+public:
+    virtual ~Backend() = default;
+
+    virtual void addDirectories(const QStringList &directories) = 0;
+    virtual void removeDirectories(const QStringList &directories) = 0;
+    virtual void setCoalesceInterval(int msec) = 0;
+};
+
+#ifdef Q_OS_LINUX
+/**
+ * @brief Owns one inotify descriptor, all watch bookkeeping happens on its worker thread.
+ */
+class ROSFileSystemWatcher::InotifyBackend : public ROSFileSystemWatcher::Backend
+{
+public:
+    InotifyBackend(ROSFileSystemWatcher *watcher, int inotifyFd, int wakeFd) :
+        m_watcher(watcher),
+        m_inotifyFd(inotifyFd),
+        m_wakeFd(wakeFd),
+        m_stop(false),
+        m_interval(COALESCE_INTERVAL)
+    {
+        m_thread.reset(QThread::create([this]() { run(); }));
+        m_thread->start(QThread::LowPriority);
+    }
+
+    ~InotifyBackend() override
+    {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_stop = true;
+        }
+        wake();
+        m_thread->wait();
+
+        ::close(m_inotifyFd);
+        ::close(m_wakeFd);
+    }
+
+    /**
+     * @brief Create the backend
+     * @return The backend, nullptr if inotify is not available
+     */
+    static InotifyBackend *create(ROSFileSystemWatcher *watcher)
+    {
+        const int inotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotifyFd < 0)
+            return nullptr;
+
+        const int wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wakeFd < 0)
+        {
+            ::close(inotifyFd);
+            return nullptr;
+        }
+
+        return new InotifyBackend(watcher, inotifyFd, wakeFd);
+    }
+
+    void addDirectories(const QStringList &directories) override
+    {
+        const quint64 sequence = ++m_queuedSequence;
+        for (const QString &directory : directories)
+            m_addedAt.insert(directory, sequence);
+
+        queue({true, directories, sequence});
+    }
+
+    void removeDirectories(const QStringList &directories) override
+    {
+        for (const QString &directory : directories)
+            m_addedAt.remove(directory);
+
+        queue({false, directories, ++m_queuedSequence});
+    }
+
+    void setCoalesceInterval(int msec) override
+    {
+        m_interval = msec;
+    }
+
+private:
+    struct Command
+    {
+        bool add;
+        QStringList directories;
+        quint64 sequence; /**< @brief Order in which the GUI thread queued the command */
+    };
+
+    void queue(Command &&command)
+    {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_commands.append(std::move(command));
+        }
+        wake();
+    }
+
+    void wake()
+    {
+        const quint64 value = 1;
+        while (::write(m_wakeFd, &value, sizeof(value)) < 0 && errno == EINTR) {}
+    }
+
+    // Worker thread only, returns false if the thread should stop
+    bool processCommands()
+    {
+        quint64 value;
+        while (::read(m_wakeFd, &value, sizeof(value)) < 0 && errno == EINTR) {}
+
+        QVector<Command> commands;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_stop)
+                return false;
+
+            commands.swap(m_commands);
+        }
+
+        if (!commands.isEmpty())
+            m_processedSequence = commands.constLast().sequence;
+
+        QStringList failed;
+        for (const Command &command : std::as_const(commands))
+        {
+            for (const QString &directory : command.directories)
+            {
+                if (!command.add)
+                {
+                    removeWatch(directory);
+                    continue;
+                }
+
+                if (m_watches.contains(directory))
+                    continue;
+
+                const int wd = ::inotify_add_watch(m_inotifyFd, QFile::encodeName(directory).constData(),
+                                                   IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                                                   IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+                if (wd < 0)
+                {
+                    // A directory removed since it was scanned is reported through its parent
+                    if (errno == ENOSPC || errno == ENOMEM)
+                        failed.append(directory);
+
+                    continue;
+                }
+
+                // Several paths can lead to the same directory through symbolic links
+                m_watches.insert(directory, wd);
+                m_paths.insert(wd, directory);
+            }
+        }
+
+        if (!failed.isEmpty())
+        {
+            ROSFileSystemWatcher *watcher = m_watcher;
+            const quint64 sequence = m_processedSequence;
+            QMetaObject::invokeMethod(watcher, [this, watcher, failed, sequence]() {
+                const QStringList current = Utils::filtered(failed, [this, sequence](const QString &path) { return !isReaddedAfter(path, sequence); });
+                if (!current.isEmpty())
+                    watcher->reportFailedDirectories(current);
+            }, Qt::QueuedConnection);
+        }
+
+        return true;
+    }
+
+    // Worker thread only
+    void removeWatch(const QString &directory)
+    {
+        auto it = m_watches.find(directory);
+        if (it == m_watches.end())
+            return;
+
+        const int wd = it.value();
+        m_watches.erase(it);
+        m_paths.remove(wd, directory);
+        if (!m_paths.contains(wd))
+            ::inotify_rm_watch(m_inotifyFd, wd);
+    }
+
+    // Worker thread only, drops the watches of a directory that moved away and all below it
+    void dropSubtree(const QString &directory)
+    {
+        QStringList directories;
+        if (m_watches.contains(directory))
+            directories.append(directory);
+
+        const QString prefix = directory + QLatin1Char('/');
+        for (auto it = m_watches.lowerBound(prefix); it != m_watches.end() && it.key().startsWith(prefix); ++it)
+            directories.append(it.key());
+
+        for (const QString &path : std::as_const(directories))
+        {
+            removeWatch(path);
+            m_dropped.insert(path);
+        }
+    }
+
+    // Worker thread only
+    void readEvents()
+    {
+        alignas(struct inotify_event) char buffer[64 * 1024];
+        while (true)
+        {
+            const ssize_t length = ::read(m_inotifyFd, buffer, sizeof(buffer));
+            if (length <= 0)
+                return;
+
+            for (ssize_t offset = 0; offset < length;)
+            {
+                const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(buffer + offset);
+                offset += static_cast<ssize_t>(sizeof(struct inotify_event) + event->len);
+
+                if (event->mask & IN_Q_OVERFLOW)
+                {
+                    m_overflow = true;
+                    continue;
+                }
+
+                const QStringList paths = m_paths.values(event->wd);
+                if (event->mask & IN_IGNORED)
+                {
+                    // The kernel removed the watch, the directory is gone
+                    for (const QString &path : paths)
+                    {
+                        m_watches.remove(path);
+                        m_dropped.insert(path);
+                    }
+                    m_paths.remove(event->wd);
+                    continue;
+                }
+
+                for (const QString &path : paths)
+                {
+                    m_changed.insert(path);
+
+                    if (event->mask & IN_MOVE_SELF)
+                        dropSubtree(path);
+                    else if ((event->mask & IN_ISDIR) && (event->mask & IN_MOVED_FROM) && event->len > 0)
+                        dropSubtree(path + QLatin1Char('/') + QFile::decodeName(event->name));
+                }
+            }
+        }
+    }
+
+    // Worker thread only
+    void flush()
+    {
+        ROSFileSystemWatcher *watcher = m_watcher;
+        const QStringList changed = m_changed.values();
+        const QSet<QString> dropped = m_dropped;
+        const bool overflow = m_overflow;
+        const quint64 sequence = m_processedSequence;
+        m_changed.clear();
+        m_dropped.clear();
+        m_overflow = false;
+
+        QMetaObject::invokeMethod(watcher, [this, watcher, changed, dropped, overflow, sequence]() {
+            for (const QString &path : dropped)
+            {
+                if (isReaddedAfter(path, sequence))
+                    continue;
+
+                watcher->m_directories.remove(path);
+                m_addedAt.remove(path);
+            }
+
+            if (overflow)
+                emit watcher->rescanRequired();
+            else if (!changed.isEmpty())
+                emit watcher->directoriesChanged(changed);
+        }, Qt::QueuedConnection);
+    }
+
+    // GUI thread only, true if the directory was added again after the worker processed the given command
+    bool isReaddedAfter(const QString &directory, quint64 sequence) const
+    {
+        return m_addedAt.value(directory, 0) > sequence;
+    }
+
+    // Worker thread only
+    void run()
+    {
+        QElapsedTimer lastEvent;
+        QElapsedTimer firstEvent;
+        while (true)
+        {
+            const bool pending = !m_changed.isEmpty() || !m_dropped.isEmpty() || m_overflow;
+            int timeout = -1;
+            if (pending)
+            {
+                const qint64 quiet = m_interval - lastEvent.elapsed();
+                const qint64 latency = COALESCE_MAX_LATENCY - firstEvent.elapsed();
+                timeout = static_cast<int>(qMax<qint64>(0, qMin(quiet, latency)));
+            }
+
+            struct pollfd fds[2];
+            fds[0].fd = m_inotifyFd;
+            fds[0].events = POLLIN;
+            fds[0].revents = 0;
+            fds[1].fd = m_wakeFd;
+            fds[1].events = POLLIN;
+            fds[1].revents = 0;
+
+            const int result = ::poll(fds, 2, timeout);
+            if (result < 0 && errno != EINTR)
+                return;
+
+            if (result > 0 && (fds[1].revents & POLLIN) && !processCommands())
+                return;
+
+            if (result > 0 && (fds[0].revents & POLLIN))
+            {
+                if (!pending)
+                    firstEvent.start();
+
+                lastEvent.start();
+                readEvents();
+            }
+
+            if ((!m_changed.isEmpty() || !m_dropped.isEmpty() || m_overflow)
+                && (lastEvent.elapsed() >= m_interval || firstEvent.elapsed() >= COALESCE_MAX_LATENCY))
+            {
+                flush();
+            }
+        }
+    }
+
+    ROSFileSystemWatcher *m_watcher;
+    std::unique_ptr<QThread> m_thread;
+    const int m_inotifyFd;
+    const int m_wakeFd;
+
+    // Shared with the GUI thread
+    QMutex m_mutex;
+    QVector<Command> m_commands;
+    bool m_stop;
+    std::atomic<int> m_interval;
+
+    // Owned by the GUI thread, a drop only applies to the watch created by an earlier add
+    quint64 m_queuedSequence = 0;
+    QHash<QString, quint64> m_addedAt; /**< @brief Directory to the sequence of the command that last added it */
+
+    // Owned by the worker thread
+    quint64 m_processedSequence = 0;   /**< @brief Sequence of the last command applied to the watches */
+    QMap<QString, int> m_watches;      /**< @brief Directory to watch descriptor, ordered to find subtrees */
+    QMultiHash<int, QString> m_paths;  /**< @brief Watch descriptor to directories */
+    QSet<QString> m_changed;
+    QSet<QString> m_dropped;
+    bool m_overflow = false;
+};
+#endif
+
+/**
+ * @brief Batches the signals of a QFileSystemWatcher on the GUI thread.
+ */
+class ROSFileSystemWatcher::FallbackBackend : public ROSFileSystemWatcher::Backend
+{
+public:
+    explicit FallbackBackend(ROSFileSystemWatcher *watcher) :
+        m_watcher(watcher)
+    {
+        m_timer.setSingleShot(true);
+        m_timer.setInterval(COALESCE_INTERVAL);
+
+        QObject::connect(&m_fileSystemWatcher, &QFileSystemWatcher::directoryChanged, watcher, [this](const QString &path) {
+            m_changed.insert(path);
+            m_timer.start();
+        });
+
+        QObject::connect(&m_timer, &QTimer::timeout, watcher, [this]() {
+            const QStringList changed = m_changed.values();
+            m_changed.clear();
+
+            // QFileSystemWatcher stops watching removed directories on its own
+            for (const QString &path : changed)
+            {
+                if (!QFileInfo::exists(path))
+                    m_watcher->m_directories.remove(path);
+            }
+
+            emit m_watcher->directoriesChanged(changed);
+        });
+    }
+
+    void addDirectories(const QStringList &directories) override
+    {
+        const QStringList failed = m_fileSystemWatcher.addPaths(directories);
+        QStringList reported;
+        for (const QString &path : failed)
+        {
+            if (QFileInfo::exists(path))
+                reported.append(path);
+        }
+
+        if (!reported.isEmpty())
+            m_watcher->reportFailedDirectories(reported);
+    }
+
+    void removeDirectories(const QStringList &directories) override
+    {
+        m_fileSystemWatcher.removePaths(directories);
+        for (const QString &path : directories)
+            m_changed.remove(path);
+    }
+
+    void setCoalesceInterval(int msec) override
+    {
+        m_timer.setInterval(msec);
+    }
+
+private:
+    ROSFileSystemWatcher *m_watcher;
+    QFileSystemWatcher m_fileSystemWatcher;
+    QTimer m_timer;
+    QSet<QString> m_changed;
+};
+
+ROSFileSystemWatcher::ROSFileSystemWatcher(QObject *parent) :
+    QObject(parent)
+{
+#ifdef Q_OS_LINUX
+    m_backend.reset(InotifyBackend::create(this));
+#endif
+    if (!m_backend)
+        m_backend.reset(new FallbackBackend(this));
+}
+
+ROSFileSystemWatcher::~ROSFileSystemWatcher() = default;
+
+void ROSFileSystemWatcher::setDirectories(const QStringList &directories)
+{
+    const QSet<QString> next(directories.begin(), directories.end());
+
+    QStringList removed;
+    for (const QString &directory : std::as_const(m_directories))
+    {
+        if (!next.contains(directory))
+            removed.append(directory);
+    }
+
+    QStringList added;
+    for (const QString &directory : next)
+    {
+        if (!m_directories.contains(directory))
+            added.append(directory);
+    }
+
+    m_directories = next;
+
+    if (!removed.isEmpty())
+        m_backend->removeDirectories(removed);
+
+    if (!added.isEmpty())
+        m_backend->addDirectories(added);
+}
+
+void ROSFileSystemWatcher::addDirectories(const QStringList &directories)
+{
+    QStringList added;
+    for (const QString &directory : directories)
+    {
+        if (!m_directories.contains(directory))
+        {
+            m_directories.insert(directory);
+            added.append(directory);
+        }
+    }
+
+    if (!added.isEmpty())
+        m_backend->addDirectories(added);
+}
+
+void ROSFileSystemWatcher::removeDirectories(const QStringList &directories)
+{
+    QStringList removed;
+    for (const QString &directory : directories)
+    {
+        if (m_directories.remove(directory))
+            removed.append(directory);
+    }
+
+    if (!removed.isEmpty())
+        m_backend->removeDirectories(removed);
+}
+
+void ROSFileSystemWatcher::clear()
+{
+    setDirectories(QStringList());
+}
+
+QStringList ROSFileSystemWatcher::directories() const
+{
+    return m_directories.values();
+}
+
+void ROSFileSystemWatcher::setCoalesceInterval(int msec)
+{
+    m_backend->setCoalesceInterval(qMax(0, msec));
+}
+
+void ROSFileSystemWatcher::reportFailedDirectories(const QStringList &directories)
+{
+    // Forget them so the next scan tries again
+    for (const QString &directory : directories)
+        m_directories.remove(directory);
+
+    Core::MessageManager::writeSilently(QObject::tr("[ROS Warning] Unable to watch %1 directories for changes, "
+                                                    "the system watch limit (fs.inotify.max_user_watches on Linux) was reached.").arg(directories.size()));
+}
+
+} // namespace Internal
+} // namespace ROSProjectManager
@@ -0,0 +1,107 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ROS_FILE_SYSTEM_WATCHER_H
+#define ROS_FILE_SYSTEM_WATCHER_H
+
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+
+namespace ROSProjectManager {
+namespace Internal {
+
+/**
+ * @brief Watches a set of directories for changes to their listing.
+ *
+ * On Linux a single inotify descriptor is owned by a worker thread, so adding and
+ * removing watches never blocks the GUI thread. Watches of deleted or moved directories
+ * are dropped by the worker as soon as the kernel reports it. Bursts of events are
+ * coalesced and delivered as one batch of changed directories on the thread the
+ * watcher lives in. On other platforms QFileSystemWatcher is used with the same batching.
+ */
+class ROSFileSystemWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ROSFileSystemWatcher(QObject *parent = nullptr);
+    ~ROSFileSystemWatcher() override;
+
+    /**
+     * @brief Set the watched directories, only the difference to the current set is applied
+     * @param directories Absolute directory paths
+     */
+    void setDirectories(const QStringList &directories);
+
+    /**
+     * @brief Watch additional directories
+     * @param directories Absolute directory paths
+     */
+    void addDirectories(const QStringList &directories);
+
+    /**
+     * @brief Stop watching directories
+     * @param directories Absolute directory paths
+     */
+    void removeDirectories(const QStringList &directories);
+
+    /**
+     * @brief Stop watching all directories
+     */
+    void clear();
+
+    /**
+     * @brief Get the watched directories
+     * @return QStringList The directories requested to be watched
+     */
+    QStringList directories() const;
+
+    /**
+     * @brief Set how long events are collected before a batch is delivered
+     * @param msec Time without new events in milliseconds
+     */
+    void setCoalesceInterval(int msec);
+
+signals:
+    /** @brief The listing of the directories changed or the directories were removed */
+    void directoriesChanged(const QStringList &directories);
+
+    /** @brief Events were lost, the watched directories must be rescanned */
+    void rescanRequired();
+
+private:
+    class Backend;
+    class InotifyBackend;
+    class FallbackBackend;
+
+    void reportFailedDirectories(const QStringList &directories);
+
+    QSet<QString> m_directories;
+    std::unique_ptr<Backend> m_backend;
+};
+
+} // namespace Internal
+} // namespace ROSProjectManager
+
+#endif // ROS_FILE_SYSTEM_WATCHER_H
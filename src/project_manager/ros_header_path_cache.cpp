@@ -0,0 +1,226 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ros_header_path_cache.h"
+
+#include <coreplugin/icore.h>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+namespace ROSProjectManager {
+namespace Internal {
+
+// Increment whenever the layout of the cache file changes
+static const quint32 HEADER_PATH_CACHE_MAGIC = 0x524f5348; // "ROSH"
+static const quint32 HEADER_PATH_CACHE_VERSION = 2;
+
+std::shared_ptr<ROSHeaderPathCache> ROSHeaderPathCache::forKit(const Utils::Id &kitId)
+{
+    // Only the projects hold the caches, a kit no longer used by any project is released
+    static QHash<Utils::Id, std::weak_ptr<ROSHeaderPathCache>> caches;
+
+    std::shared_ptr<ROSHeaderPathCache> cache = caches.value(kitId).lock();
+    if (cache)
+        return cache;
+
+    const QString name = QString::fromLatin1(QCryptographicHash::hash(kitId.name(), QCryptographicHash::Sha1).toHex().left(16));
+    cache = std::make_shared<ROSHeaderPathCache>(Core::ICore::cacheResourcePath(QLatin1String("ros_qtc_plugin")).pathAppended(QLatin1String("headerpaths-") + name + QLatin1String(".cache")));
+    cache->load();
+    caches.insert(kitId, cache);
+    return cache;
+}
+
+QByteArray ROSHeaderPathCache::toolChainKey(const ProjectExplorer::ToolChain *toolChain, const Utils::Environment &env)
+{
+    QCryptographicHash key(QCryptographicHash::Sha1);
+    key.addData(toolChain->id());
+    key.addData(toolChain->compilerCommand().toString().toUtf8());
+
+    // A bare command name is run from the PATH of the build environment, not from the working directory
+    Utils::FilePath command = env.searchInPath(toolChain->compilerCommand().toString());
+    if (command.isEmpty())
+        command = toolChain->compilerCommand();
+
+    key.addData(command.toString().toUtf8());
+
+    // A compiler update installs a new binary at the same path
+    const QFileInfo compiler(command.toString());
+    key.addData(QByteArray::number(compiler.lastModified().toMSecsSinceEpoch()));
+    key.addData(QByteArray::number(compiler.size()));
+
+    // The compiler adds these to its built-in include directories
+    for (const char *variable : {"CPATH", "C_INCLUDE_PATH", "CPLUS_INCLUDE_PATH"})
+        key.addData(env.value(QLatin1String(variable)).toUtf8() + '\n');
+
+    return key.result();
+}
+
+QStringList ROSHeaderPathCache::relevantFlags(const QStringList &flags)
+{
+    QStringList relevant;
+    for (int i = 0; i < flags.size(); ++i)
+    {
+        const QString &flag = flags.at(i);
+        if (flag == QLatin1String("--sysroot") || flag == QLatin1String("-isysroot")
+            || flag == QLatin1String("-target") || flag == QLatin1String("-arch"))
+        {
+            // The value is the next argument
+            relevant.append(flag);
+            if (i + 1 < flags.size())
+                relevant.append(flags.at(++i));
+        }
+        else if (flag.startsWith(QLatin1String("-std=")) || flag.startsWith(QLatin1String("-stdlib="))
+                 || flag.startsWith(QLatin1String("--stdlib=")) || flag.startsWith(QLatin1String("-specs="))
+                 || flag.startsWith(QLatin1String("--specs=")) || flag.startsWith(QLatin1String("-m"))
+                 || flag.startsWith(QLatin1String("--sysroot=")) || flag.startsWith(QLatin1String("-nostdinc"))
+                 || flag.startsWith(QLatin1String("--target=")) || flag.startsWith(QLatin1String("--gcc-toolchain=")))
+        {
+            relevant.append(flag);
+        }
+    }
+
+    return relevant;
+}
+
+ROSHeaderPathCache::ROSHeaderPathCache(const Utils::FilePath &cacheFile) :
+    m_cacheFile(cacheFile),
+    m_dirty(false)
+{
+}
+
+ProjectExplorer::HeaderPaths ROSHeaderPathCache::headerPaths(const QByteArray &toolChainKey,
+                                                             const QStringList &flags,
+                                                             const Utils::FilePath &sysRoot,
+                                                             const ProjectExplorer::ToolChain::BuiltInHeaderPathsRunner &runner)
+{
+    const QStringList relevant = relevantFlags(flags);
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(toolChainKey);
+    hash.addData(relevant.join(QLatin1Char('\n')).toUtf8());
+    hash.addData(QByteArray(1, '\0'));
+    hash.addData(sysRoot.toString().toUtf8());
+    const QByteArray key = hash.result();
+
+    {
+        QMutexLocker locker(&m_mutex);
+        const auto it = m_entries.constFind(key);
+        if (it != m_entries.constEnd())
+            return it.value();
+    }
+
+    // The compiler only sees the flags that are part of the key, so the result is valid for every target sharing it.
+    // Two threads may both miss and run the compiler, both get the same result.
+    const ProjectExplorer::HeaderPaths paths = runner(relevant, sysRoot, QString());
+
+    QMutexLocker locker(&m_mutex);
+    m_entries.insert(key, paths);
+    m_dirty = true;
+    return paths;
+}
+
+bool ROSHeaderPathCache::load()
+{
+    QFile file(m_cacheFile.toString());
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (magic != HEADER_PATH_CACHE_MAGIC || version != HEADER_PATH_CACHE_VERSION)
+        return false;
+
+    qint32 count = 0;
+    in >> count;
+
+    QHash<QByteArray, ProjectExplorer::HeaderPaths> entries;
+    entries.reserve(count);
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+    {
+        QByteArray key;
+        qint32 pathCount = 0;
+        in >> key >> pathCount;
+
+        ProjectExplorer::HeaderPaths paths;
+        paths.reserve(pathCount);
+        for (qint32 j = 0; j < pathCount && in.status() == QDataStream::Ok; ++j)
+        {
+            QString path;
+            qint32 type = 0;
+            in >> path >> type;
+            paths.append(ProjectExplorer::HeaderPath(path, static_cast<ProjectExplorer::HeaderPathType>(type)));
+        }
+
+        entries.insert(key, paths);
+    }
+
+    // A truncated or corrupt cache is treated as missing
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    QMutexLocker locker(&m_mutex);
+    m_entries = std::move(entries);
+    m_dirty = false;
+    return true;
+}
+
+bool ROSHeaderPathCache::save()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_dirty)
+        return true;
+
+    if (!QDir().mkpath(m_cacheFile.parentDir().toString()))
+        return false;
+
+    QSaveFile file(m_cacheFile.toString());
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << HEADER_PATH_CACHE_MAGIC << HEADER_PATH_CACHE_VERSION << static_cast<qint32>(m_entries.size());
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it)
+    {
+        out << it.key() << static_cast<qint32>(it.value().size());
+        for (const ProjectExplorer::HeaderPath &path : it.value())
+            out << path.path << static_cast<qint32>(path.type);
+    }
+
+    if (out.status() != QDataStream::Ok || !file.commit())
+        return false;
+
+    m_dirty = false;
+    return true;
+}
+
+} // namespace Internal
+} // namespace ROSProjectManager
@@ -0,0 +1,123 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ROS_HEADER_PATH_CACHE_H
+#define ROS_HEADER_PATH_CACHE_H
+
+#include <projectexplorer/headerpath.h>
+#include <projectexplorer/toolchain.h>
+#include <utils/environment.h>
+#include <utils/filepath.h>
+#include <utils/id.h>
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QStringList>
+
+#include <memory>
+
+namespace ROSProjectManager {
+namespace Internal {
+
+/**
+ * @brief On-disk cache of the built-in header paths of the C++ tool chain of a kit.
+ *
+ * Querying the built-in header paths runs the compiler, but almost every target of a
+ * workspace shares one of a handful of configurations. The header paths are cached by
+ * tool chain, the subset of the flags that changes them and the sysroot, so the compiler
+ * only runs once per configuration. The cache is shared by all projects using the same
+ * kit and kept across sessions.
+ *
+ * headerPaths() and save() may be called from any thread.
+ */
+class ROSHeaderPathCache
+{
+public:
+    /**
+     * @brief Get the cache of a kit, it is loaded from disk the first time it is used
+     * @note Must be called from the GUI thread.
+     * @param kitId The kit id
+     * @return The cache shared by all projects using the kit
+     */
+    static std::shared_ptr<ROSHeaderPathCache> forKit(const Utils::Id &kitId);
+
+    /**
+     * @brief Get the key identifying a tool chain and the compiler it runs
+     * @note Must be called from the GUI thread.
+     * @param toolChain The C++ tool chain
+     * @param env The build environment
+     * @return The key, changes if the compiler is replaced or an include path variable changes
+     */
+    static QByteArray toolChainKey(const ProjectExplorer::ToolChain *toolChain, const Utils::Environment &env);
+
+    /**
+     * @brief Get the flags which change the built-in header paths
+     * @param flags The compiler flags of a target
+     * @return The language standard, standard library, spec file, machine, sysroot, target and -nostdinc flags
+     *         in their original order
+     */
+    static QStringList relevantFlags(const QStringList &flags);
+
+    /**
+     * @brief Constructor
+     * @param cacheFile Path to the cache file
+     */
+    explicit ROSHeaderPathCache(const Utils::FilePath &cacheFile);
+
+    /**
+     * @brief Get the built-in header paths, the runner is only called if they are not cached yet
+     * @param toolChainKey The key returned by toolChainKey()
+     * @param flags The compiler flags of a target
+     * @param sysRoot The sysroot of the kit
+     * @param runner The built-in header paths runner of the tool chain
+     * @return The built-in header paths
+     */
+    ProjectExplorer::HeaderPaths headerPaths(const QByteArray &toolChainKey,
+                                             const QStringList &flags,
+                                             const Utils::FilePath &sysRoot,
+                                             const ProjectExplorer::ToolChain::BuiltInHeaderPathsRunner &runner);
+
+    /**
+     * @brief Load the cache from disk, discarding it if the version does not match
+     * @return False if the file does not exist or is invalid, otherwise true
+     */
+    bool load();
+
+    /**
+     * @brief Save the cache if configurations were added since it was loaded or saved
+     * @return False if the file could not be written, otherwise true
+     */
+    bool save();
+
+    /** @brief Get the path to the cache file */
+    Utils::FilePath cacheFile() const { return m_cacheFile; }
+
+private:
+    Utils::FilePath m_cacheFile;
+    mutable QMutex m_mutex;
+    QHash<QByteArray, ProjectExplorer::HeaderPaths> m_entries; /**< @brief Configuration key, built-in header paths */
+    bool m_dirty;
+};
+
+} // namespace Internal
+} // namespace ROSProjectManager
+
+#endif // ROS_HEADER_PATH_CACHE_H
@@ -0,0 +1,309 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ros_package_graph.h"
+
+#include <algorithm>
+#include <set>
+
+namespace ROSProjectManager {
+namespace Internal {
+
+ROSPackageDependencyGraph::ROSPackageDependencyGraph()
+{
+}
+
+ROSPackageDependencyGraph::ROSPackageDependencyGraph(const ROSUtils::PackageInfoMap &packages, DependencyTypes types)
+{
+    // The map is sorted by name, so are the indexes
+    m_names = packages.keys();
+    m_indexes.reserve(m_names.size());
+    m_pathIndexes.reserve(m_names.size());
+    for (int i = 0; i < m_names.size(); ++i)
+    {
+        m_indexes.insert(m_names.at(i), i);
+        m_pathIndexes.insert(packages.value(m_names.at(i)).path.toString(), i);
+    }
+
+    m_dependencies.resize(m_names.size());
+    m_dependents.resize(m_names.size());
+    for (int i = 0; i < m_names.size(); ++i)
+    {
+        const ROSUtils::PackageInfo &package = packages.value(m_names.at(i));
+        QStringList depends;
+        if (types & BuildDependency)
+            depends.append(package.buildDepends);
+        if (types & BuildExportDependency)
+            depends.append(package.buildExportDepends);
+        if (types & BuildToolDependency)
+            depends.append(package.buildToolDepend);
+        if (types & ExecDependency)
+            depends.append(package.execDepends);
+        if (types & TestDependency)
+            depends.append(package.testDepends);
+
+        for (const QString &depend : std::as_const(depends))
+        {
+            const int dependency = m_indexes.value(depend, -1);
+            if (dependency >= 0)
+                m_dependencies[i].append(dependency);
+        }
+
+        std::sort(m_dependencies[i].begin(), m_dependencies[i].end());
+        m_dependencies[i].erase(std::unique(m_dependencies[i].begin(), m_dependencies[i].end()), m_dependencies[i].end());
+        for (int dependency : std::as_const(m_dependencies[i]))
+            m_dependents[dependency].append(i);
+    }
+
+    // Kahn's algorithm, among the packages ready to go the one with the smallest name is taken first
+    QVector<int> pending(m_names.size());
+    std::set<int> ready;
+    for (int i = 0; i < m_names.size(); ++i)
+    {
+        pending[i] = static_cast<int>(m_dependencies.at(i).size());
+        if (pending[i] == 0)
+            ready.insert(i);
+    }
+
+    m_order.reserve(m_names.size());
+    QVector<bool> ordered(m_names.size(), false);
+    while (!ready.empty())
+    {
+        const int index = *ready.begin();
+        ready.erase(ready.begin());
+        m_order.append(index);
+        ordered[index] = true;
+        for (int dependent : std::as_const(m_dependents.at(index)))
+        {
+            if (--pending[dependent] == 0)
+                ready.insert(dependent);
+        }
+    }
+
+    for (int i = 0; i < m_names.size(); ++i)
+    {
+        if (!ordered.at(i))
+            m_order.append(i);
+    }
+}
+
+bool ROSPackageDependencyGraph::isEmpty() const
+{
+    return m_names.isEmpty();
+}
+
+bool ROSPackageDependencyGraph::contains(const QString &package) const
+{
+    return m_indexes.contains(package);
+}
+
+QStringList ROSPackageDependencyGraph::packages() const
+{
+    return m_names;
+}
+
+QStringList ROSPackageDependencyGraph::dependencies(const QString &package) const
+{
+    const int index = m_indexes.value(package, -1);
+    return index < 0 ? QStringList() : names(m_dependencies.at(index));
+}
+
+QStringList ROSPackageDependencyGraph::dependents(const QString &package) const
+{
+    const int index = m_indexes.value(package, -1);
+    return index < 0 ? QStringList() : names(m_dependents.at(index));
+}
+
+QStringList ROSPackageDependencyGraph::topologicalOrder() const
+{
+    return names(m_order);
+}
+
+QStringList ROSPackageDependencyGraph::reverseDependencies(const QString &package) const
+{
+    const int index = m_indexes.value(package, -1);
+    if (index < 0)
+        return QStringList();
+
+    QStringList affected = affectedPackages(QStringList(package));
+    affected.removeOne(package);
+    return affected;
+}
+
+QStringList ROSPackageDependencyGraph::affectedPackages(const QStringList &packages) const
+{
+    QVector<bool> selected(m_names.size(), false);
+    QVector<int> pending;
+    for (const QString &package : packages)
+    {
+        const int index = m_indexes.value(package, -1);
+        if (index >= 0 && !selected.at(index))
+        {
+            selected[index] = true;
+            pending.append(index);
+        }
+    }
+
+    while (!pending.isEmpty())
+    {
+        const int index = pending.takeLast();
+        for (int dependent : std::as_const(m_dependents.at(index)))
+        {
+            if (!selected.at(dependent))
+            {
+                selected[dependent] = true;
+                pending.append(dependent);
+            }
+        }
+    }
+
+    return topologicallySorted(selected);
+}
+
+QString ROSPackageDependencyGraph::packageForFile(const Utils::FilePath &file) const
+{
+    // Packages are never nested, the first package directory above the file is its package
+    QString path = file.toString();
+    while (!path.isEmpty())
+    {
+        const auto it = m_pathIndexes.constFind(path);
+        if (it != m_pathIndexes.constEnd())
+            return m_names.at(it.value());
+
+        const int separator = static_cast<int>(path.lastIndexOf(QLatin1Char('/')));
+        if (separator < 0)
+            break;
+
+        path.truncate(separator);
+    }
+
+    return QString();
+}
+
+QStringList ROSPackageDependencyGraph::packagesAffectedByFile(const Utils::FilePath &file) const
+{
+    const QString package = packageForFile(file);
+    return package.isEmpty() ? QStringList() : affectedPackages(QStringList(package));
+}
+
+QList<QStringList> ROSPackageDependencyGraph::cycles() const
+{
+    // Iterative Tarjan, every strongly connected component with more than one package is a cycle
+    const int count = static_cast<int>(m_names.size());
+    QVector<int> indexes(count, -1);
+    QVector<int> lowLinks(count, 0);
+    QVector<bool> onStack(count, false);
+    QVector<int> stack;
+    QList<QStringList> cycles;
+    int next = 0;
+
+    struct Frame
+    {
+        int node;
+        int edge;
+    };
+
+    for (int root = 0; root < count; ++root)
+    {
+        if (indexes.at(root) >= 0)
+            continue;
+
+        QVector<Frame> frames;
+        frames.append({root, 0});
+        indexes[root] = lowLinks[root] = next++;
+        stack.append(root);
+        onStack[root] = true;
+
+        while (!frames.isEmpty())
+        {
+            Frame &frame = frames.last();
+            const QVector<int> &edges = m_dependencies.at(frame.node);
+            if (frame.edge < edges.size())
+            {
+                const int target = edges.at(frame.edge++);
+                if (indexes.at(target) < 0)
+                {
+                    indexes[target] = lowLinks[target] = next++;
+                    stack.append(target);
+                    onStack[target] = true;
+                    frames.append({target, 0});
+                }
+                else if (onStack.at(target))
+                {
+                    lowLinks[frame.node] = qMin(lowLinks.at(frame.node), indexes.at(target));
+                }
+                continue;
+            }
+
+            const int node = frame.node;
+            frames.removeLast();
+            if (!frames.isEmpty())
+                lowLinks[frames.last().node] = qMin(lowLinks.at(frames.last().node), lowLinks.at(node));
+
+            if (lowLinks.at(node) != indexes.at(node))
+                continue;
+
+            QVector<int> component;
+            int member = -1;
+            do
+            {
+                member = stack.takeLast();
+                onStack[member] = false;
+                component.append(member);
+            } while (member != node);
+
+            if (component.size() > 1 || m_dependencies.at(node).contains(node))
+            {
+                std::sort(component.begin(), component.end());
+                cycles.append(names(component));
+            }
+        }
+    }
+
+    std::sort(cycles.begin(), cycles.end(), [](const QStringList &lhs, const QStringList &rhs) {
+        return lhs.first() < rhs.first();
+    });
+    return cycles;
+}
+
+QStringList ROSPackageDependencyGraph::names(const QVector<int> &indexes) const
+{
+    QStringList result;
+    result.reserve(indexes.size());
+    for (int index : indexes)
+        result.append(m_names.at(index));
+
+    return result;
+}
+
+QStringList ROSPackageDependencyGraph::topologicallySorted(const QVector<bool> &selected) const
+{
+    QStringList result;
+    for (int index : m_order)
+    {
+        if (selected.at(index))
+            result.append(m_names.at(index));
+    }
+
+    return result;
+}
+
+} // namespace Internal
+} // namespace ROSProjectManager
@@ -0,0 +1,153 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ROS_PACKAGE_GRAPH_H
+#define ROS_PACKAGE_GRAPH_H
+
+#include "ros_utils.h"
+
+#include <utils/filepath.h>
+
+#include <QFlags>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace ROSProjectManager {
+namespace Internal {
+
+/**
+ * @brief Dependency graph of the packages in a workspace.
+ *
+ * Only dependencies between workspace packages are part of the graph, dependencies on
+ * underlay or system packages are ignored. All results are sorted or in topological
+ * order, so they do not depend on the order packages were parsed in.
+ */
+class ROSPackageDependencyGraph
+{
+public:
+    /** @brief The package.xml dependency kinds that form edges of the graph */
+    enum DependencyType
+    {
+        BuildDependency       = 0x01,
+        BuildExportDependency = 0x02,
+        BuildToolDependency   = 0x04,
+        ExecDependency        = 0x08,
+        TestDependency        = 0x10,
+        AllDependencies       = 0x1f
+    };
+    Q_DECLARE_FLAGS(DependencyTypes, DependencyType)
+
+    /** @brief Create an empty graph */
+    ROSPackageDependencyGraph();
+
+    /**
+     * @brief Create the graph of a workspace
+     * @param packages The workspace packages
+     * @param types The dependency kinds to include
+     */
+    explicit ROSPackageDependencyGraph(const ROSUtils::PackageInfoMap &packages, DependencyTypes types = AllDependencies);
+
+    /** @brief Check if the graph has no packages */
+    bool isEmpty() const;
+
+    /** @brief Check if a package is part of the graph */
+    bool contains(const QString &package) const;
+
+    /** @brief Get the names of all packages, sorted */
+    QStringList packages() const;
+
+    /**
+     * @brief Get the workspace packages a package depends on directly
+     * @param package The package name
+     * @return The sorted package names
+     */
+    QStringList dependencies(const QString &package) const;
+
+    /**
+     * @brief Get the workspace packages depending directly on a package
+     * @param package The package name
+     * @return The sorted package names
+     */
+    QStringList dependents(const QString &package) const;
+
+    /**
+     * @brief Get all packages with dependencies before their dependents.
+     *
+     * Packages that are part of a cycle, or depend on one, are appended in name order after all other packages.
+     *
+     * @return The package names in topological order
+     */
+    QStringList topologicalOrder() const;
+
+    /**
+     * @brief Get the packages depending directly or indirectly on a package
+     * @param package The package name
+     * @return The package names in topological order, without the package itself
+     */
+    QStringList reverseDependencies(const QString &package) const;
+
+    /**
+     * @brief Get the packages that have to be rebuilt if the given packages change
+     * @param packages The changed package names, unknown names are ignored
+     * @return The changed packages and their reverse dependencies in topological order
+     */
+    QStringList affectedPackages(const QStringList &packages) const;
+
+    /**
+     * @brief Get the package containing a file
+     * @param file The absolute file path
+     * @return The package name, empty if the file is not in a workspace package
+     */
+    QString packageForFile(const Utils::FilePath &file) const;
+
+    /**
+     * @brief Get the packages that have to be rebuilt if a file changes
+     * @param file The absolute file path
+     * @return The affected packages in topological order, empty if the file is not in a workspace package
+     */
+    QStringList packagesAffectedByFile(const Utils::FilePath &file) const;
+
+    /**
+     * @brief Get the dependency cycles
+     * @return The sorted packages of each cycle, a package depending on itself is a cycle as well
+     */
+    QList<QStringList> cycles() const;
+
+private:
+    QStringList names(const QVector<int> &indexes) const;
+    QStringList topologicallySorted(const QVector<bool> &selected) const;
+
+    QStringList m_names;                  /**< @brief Sorted package names, the index identifies a package */
+    QHash<QString, int> m_indexes;
+    QHash<QString, int> m_pathIndexes;    /**< @brief Package directory to package index */
+    QVector<QVector<int>> m_dependencies; /**< @brief Sorted indexes of the direct dependencies */
+    QVector<QVector<int>> m_dependents;   /**< @brief Sorted indexes of the direct dependents */
+    QVector<int> m_order;                 /**< @brief Package indexes in topological order */
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(ROSPackageDependencyGraph::DependencyTypes)
+
+} // namespace Internal
+} // namespace ROSProjectManager
+
+#endif // ROS_PACKAGE_GRAPH_H
@@ -0,0 +1,195 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ros_package_index.h"
+#include "ros_directory_walker.h"
+#include "ros_packagexml_parser.h"
+#include "ros_path_filter.h"
+
+#include <projectexplorer/projectexplorer.h>
+
+#include <QFileInfo>
+#include <QMutexLocker>
+
+#include <algorithm>
+
+namespace ROSProjectManager {
+namespace Internal {
+
+QMutex ROSPackageIndex::s_mutex;
+QHash<QString, ROSPackageIndex::Prefix> ROSPackageIndex::s_prefixes;
+
+/** @brief Get the value of a variable from KEY=VALUE entries */
+static QString environmentValue(const QStringList &env, const QString &name)
+{
+    const QString key = name + QLatin1Char('=');
+    for (const QString &entry : env)
+    {
+        if (entry.startsWith(key))
+            return entry.mid(key.size());
+    }
+
+    return QString();
+}
+
+QMap<QString, QString> ROSPackageIndex::packages(const QStringList &env)
+{
+    QMap<QString, QString> packages;
+    const auto merge = [&packages](const QMap<QString, QString> &prefixPackages) {
+        // Overlays come first in the search paths, a package found before is never replaced
+        for (auto it = prefixPackages.constBegin(); it != prefixPackages.constEnd(); ++it)
+        {
+            if (!packages.contains(it.key()))
+                packages.insert(it.key(), it.value());
+        }
+    };
+
+    const QStringList amentPrefixes = environmentValue(env, QLatin1String("AMENT_PREFIX_PATH")).split(QLatin1Char(':'), Qt::SkipEmptyParts);
+    for (const QString &prefix : amentPrefixes)
+        merge(prefixPackages(QLatin1String("ament:") + prefix, prefix, true));
+
+    const QStringList packagePaths = environmentValue(env, QLatin1String("ROS_PACKAGE_PATH")).split(QLatin1Char(':'), Qt::SkipEmptyParts);
+    for (const QString &path : packagePaths)
+        merge(prefixPackages(QLatin1String("ros:") + path, path, false));
+
+    return packages;
+}
+
+QString ROSPackageIndex::packagePath(const QString &packageName, const QStringList &env)
+{
+    return packages(env).value(packageName);
+}
+
+void ROSPackageIndex::clear()
+{
+    QMutexLocker locker(&s_mutex);
+    s_prefixes.clear();
+}
+
+QMap<QString, QString> ROSPackageIndex::prefixPackages(const QString &key, const QString &path, bool ament)
+{
+    {
+        QMutexLocker locker(&s_mutex);
+        const auto it = s_prefixes.constFind(key);
+        if (it != s_prefixes.constEnd() && isValid(it.value()))
+            return it.value().packages;
+    }
+
+    // Read without holding the lock, a concurrent reader of the same prefix produces the same entry
+    Prefix prefix = ament ? readAmentPrefix(path) : readPackagePath(path);
+    const QMap<QString, QString> packages = prefix.packages;
+
+    QMutexLocker locker(&s_mutex);
+    s_prefixes.insert(key, std::move(prefix));
+    return packages;
+}
+
+bool ROSPackageIndex::isValid(const Prefix &prefix)
+{
+    for (auto it = prefix.stamps.constBegin(); it != prefix.stamps.constEnd(); ++it)
+    {
+        if (ROSWorkspaceScanCache::directoryStamp(it.key()) != it.value())
+            return false;
+    }
+
+    return true;
+}
+
+ROSPackageIndex::Prefix ROSPackageIndex::readAmentPrefix(const QString &prefix)
+{
+    // Every registered package has an empty marker file named after it
+    Prefix result;
+    const QString resources = prefix + QLatin1String("/share/ament_index/resource_index/packages");
+    result.stamps.insert(resources, ROSWorkspaceScanCache::directoryStamp(resources));
+
+    const ROSUtils::FolderContent content = ROSUtils::getFolderContent(resources);
+    for (const QString &package : content.files)
+    {
+        if (!package.startsWith(QLatin1Char('.')))
+            result.packages.insert(package, prefix + QLatin1String("/share/") + package);
+    }
+
+    return result;
+}
+
+ROSPackageIndex::Prefix ROSPackageIndex::readPackagePath(const QString &path)
+{
+    Prefix result;
+    QMutex resultMutex;
+    QList<std::pair<QString, QString>> found; // Package directory, package name
+
+    // Like rospack, package directories and ignored directories are not descended into
+    ROSDirectoryWalker walker([&](const QString &folder, ROSPathFilter::ScopePtr &) {
+        ROSUtils::FolderContent content = ROSUtils::getFolderContent(folder);
+        const ROSWorkspaceScanCache::DirectoryStamp stamp = ROSWorkspaceScanCache::directoryStamp(folder);
+
+        QString packageName;
+        bool ignored = false;
+        for (const QString &file : std::as_const(content.files))
+        {
+            if (ROSPathFilter::isIgnoreMarker(file) || file == QLatin1String("rospack_nosubdirs"))
+                ignored = true;
+        }
+
+        if (content.files.contains(QLatin1String("package.xml")))
+        {
+            ROSPackageXmlParser parser;
+            ROSUtils::PackageInfo packageInfo;
+            if (parser.parsePackageXml(Utils::FilePath::fromString(folder).pathAppended("package.xml"), packageInfo))
+                packageName = packageInfo.name;
+        }
+
+        // rosbuild packages and unreadable manifests are named after their directory
+        if (packageName.isEmpty() && (content.files.contains(QLatin1String("manifest.xml")) || content.files.contains(QLatin1String("package.xml"))))
+            packageName = QFileInfo(folder).fileName();
+
+        // A package root is only listed again if it is renamed or removed, which changes its parent
+        QMutexLocker locker(&resultMutex);
+        if (!packageName.isEmpty())
+        {
+            found.append({folder, packageName});
+            return ROSUtils::FolderContent();
+        }
+
+        result.stamps.insert(folder, stamp);
+        if (ignored)
+            return ROSUtils::FolderContent();
+
+        content.files.clear();
+        content.directories.removeIf([](const QString &name) { return name.startsWith(QLatin1Char('.')); });
+        return content;
+    });
+
+    walker.setThreadPool(ProjectExplorer::ProjectExplorerPlugin::sharedThreadPool());
+    walker.walk(path);
+
+    // The walker visits directories in any order, duplicate names resolve the same way on every call
+    std::sort(found.begin(), found.end());
+    for (const auto &package : std::as_const(found))
+    {
+        if (!result.packages.contains(package.second))
+            result.packages.insert(package.second, package.first);
+    }
+
+    return result;
+}
+
+} // namespace Internal
+} // namespace ROSProjectManager
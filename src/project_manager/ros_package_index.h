@@ -0,0 +1,87 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ROS_PACKAGE_INDEX_H
+#define ROS_PACKAGE_INDEX_H
+
+#include "ros_workspace_scan_cache.h"
+
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+namespace ROSProjectManager {
+namespace Internal {
+
+/**
+ * @brief In memory index of the packages installed in the prefixes of an environment.
+ *
+ * For ROS 2 the ament resource index (share/ament_index/resource_index/packages) of every
+ * AMENT_PREFIX_PATH entry is read, for ROS 1 every ROS_PACKAGE_PATH entry is crawled for
+ * package.xml and manifest.xml files the way rospack does. No process is started.
+ *
+ * Each prefix is indexed once and kept until the modification time of one of the directories
+ * it was read from changes, so repeated lookups only cost a stat per indexed directory.
+ * Like the tools, the first prefix providing a package wins. The index is shared by all
+ * projects and may be used from any thread.
+ */
+class ROSPackageIndex
+{
+public:
+    /**
+     * @brief Get the packages available in an environment
+     * @param env The environment as KEY=VALUE entries
+     * @return QMap(Package Name, Path to package)
+     */
+    static QMap<QString, QString> packages(const QStringList &env);
+
+    /**
+     * @brief Get the path of a package
+     * @param packageName The package name
+     * @param env The environment as KEY=VALUE entries
+     * @return The path to the package, empty if it is not found
+     */
+    static QString packagePath(const QString &packageName, const QStringList &env);
+
+    /** @brief Drop all indexed prefixes, they are read again on the next lookup */
+    static void clear();
+
+private:
+    struct Prefix
+    {
+        QHash<QString, ROSWorkspaceScanCache::DirectoryStamp> stamps; /**< @brief The directories the prefix was read from */
+        QMap<QString, QString> packages;
+    };
+
+    static bool isValid(const Prefix &prefix);
+    static Prefix readAmentPrefix(const QString &prefix);
+    static Prefix readPackagePath(const QString &path);
+    static QMap<QString, QString> prefixPackages(const QString &key, const QString &path, bool ament);
+
+    static QMutex s_mutex;
+    static QHash<QString, Prefix> s_prefixes; /**< @brief Indexed prefixes by kind and path */
+};
+
+} // namespace Internal
+} // namespace ROSProjectManager
+
+#endif // ROS_PACKAGE_INDEX_H
@@ -0,0 +1,160 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ros_package_info_cache.h"
+#include "ros_packagexml_parser.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+
+namespace ROSProjectManager {
+namespace Internal {
+
+ROSPackageInfoCache::ROSPackageInfoCache(QObject *parent) :
+    QObject(parent)
+{
+}
+
+ROSPackageInfoCache::Entries ROSPackageInfoCache::entries() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries;
+}
+
+/**
+ * @brief Check if the variables the conditions of a manifest were evaluated with still have the same values
+ * @param entry The cached entry
+ * @param environment The current environment
+ * @return True if the parsed information is still valid for the environment
+ */
+static bool hasSameConditionVariables(const ROSPackageInfoCache::Entry &entry, const Utils::Environment &environment)
+{
+    for (auto it = entry.conditionVariables.constBegin(); it != entry.conditionVariables.constEnd(); ++it)
+    {
+        if (ROSPackageXmlParser::conditionVariable(environment, it.key()) != it.value())
+            return false;
+    }
+
+    return true;
+}
+
+bool ROSPackageInfoCache::refresh(const QString &packagePath, const Entry *previous, const Utils::Environment &environment, Entry &entry, QStringList &diagnostics)
+{
+    const Utils::FilePath filepath = Utils::FilePath::fromString(packagePath).pathAppended("package.xml");
+    const QFileInfo info(filepath.toString());
+    if (!info.isFile())
+    {
+        if (previous)
+            entry = *previous;
+
+        return false;
+    }
+
+    // Unchanged metadata, the manifest is not even read
+    const qint64 readTime = QDateTime::currentMSecsSinceEpoch() * 1000000LL;
+    const ROSWorkspaceScanCache::DirectoryStamp stamp = ROSWorkspaceScanCache::directoryStamp(filepath.toString());
+    const qint64 size = info.size();
+    if (previous && previous->parsed && stamp.isValid() && previous->stamp == stamp && previous->size == size && hasSameConditionVariables(*previous, environment))
+    {
+        entry = *previous;
+        return true;
+    }
+
+    QFile file(filepath.toString());
+    if (!file.open(QFile::ReadOnly))
+    {
+        if (previous)
+            entry = *previous;
+
+        return false;
+    }
+
+    // A manifest written just before it was read may change again without a new stamp, the next
+    // refresh compares its content instead
+    const QByteArray content = file.readAll();
+    entry.stamp = stamp.isRacy(readTime) ? ROSWorkspaceScanCache::DirectoryStamp() : stamp;
+    entry.size = size;
+    entry.hash = QCryptographicHash::hash(content, QCryptographicHash::Sha1);
+
+    // Touched but not modified, e.g. by a checkout
+    if (previous && previous->parsed && previous->hash == entry.hash && hasSameConditionVariables(*previous, environment))
+    {
+        entry.parsed = true;
+        entry.packageInfo = previous->packageInfo;
+        entry.conditionVariables = previous->conditionVariables;
+        return true;
+    }
+
+    ROSPackageXmlParser parser;
+    parser.setEnvironment(environment);
+    const bool parsed = parser.parsePackageXml(filepath, content, entry.packageInfo);
+    diagnostics.append(parser.diagnostics());
+
+    // A manifest that is being edited falls back to the last parsed information
+    if (!parsed)
+    {
+        entry = previous ? *previous : Entry();
+        return false;
+    }
+
+    entry.parsed = true;
+    entry.conditionVariables = parser.conditionVariables();
+    return true;
+}
+
+bool ROSPackageInfoCache::commit(const Entries &entries, const std::function<bool()> &isCanceled)
+{
+    QStringList changed, removed;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (isCanceled && isCanceled())
+            return false;
+
+        for (auto it = entries.constBegin(); it != entries.constEnd(); ++it)
+        {
+            const auto previous = m_entries.constFind(it.key());
+            if (previous == m_entries.constEnd() || previous.value().hash != it.value().hash || previous.value().parsed != it.value().parsed
+                || previous.value().conditionVariables != it.value().conditionVariables)
+                changed.append(it.key());
+        }
+
+        for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it)
+        {
+            if (!entries.contains(it.key()))
+                removed.append(it.key());
+        }
+
+        m_entries = entries;
+    }
+
+    if (changed.isEmpty() && removed.isEmpty())
+        return true;
+
+    changed.sort();
+    removed.sort();
+    emit packagesInvalidated(changed, removed);
+    return true;
+}
+
+} // namespace Internal
+} // namespace ROSProjectManager
@@ -0,0 +1,112 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ROS_PACKAGE_INFO_CACHE_H
+#define ROS_PACKAGE_INFO_CACHE_H
+
+#include "ros_utils.h"
+#include "ros_packagexml_parser.h"
+#include "ros_workspace_scan_cache.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QStringList>
+
+#include <functional>
+
+namespace ROSProjectManager {
+namespace Internal {
+
+/**
+ * @brief Cache of the parsed package.xml files of a workspace.
+ *
+ * A manifest is only read again if its stamp (see ROSWorkspaceScanCache::directoryStamp) or size changed and only parsed
+ * again if its content hash changed as well, or if a variable its conditions refer to changed. If a manifest can no longer be read or
+ * parsed the last parsed information is kept. Every update reports which packages changed, were added or
+ * were removed through packagesInvalidated().
+ *
+ * entries(), refresh() and commit() may be called from any thread.
+ */
+class ROSPackageInfoCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    /** @brief The cached state of one package.xml */
+    struct Entry
+    {
+        ROSWorkspaceScanCache::DirectoryStamp stamp; /**< @brief Modification time and inode, the same stamp the scan index uses, invalid if racy */
+        qint64 size = -1;                  /**< @brief File size in bytes */
+        QByteArray hash;                   /**< @brief Hash of the file content */
+        bool parsed = false;               /**< @brief True if packageInfo holds parsed information */
+        ROSUtils::PackageInfo packageInfo;
+        ROSPackageXmlParser::ConditionVariables conditionVariables; /**< @brief Variables the conditions were evaluated with */
+    };
+
+    /** @brief Package directory, Entry */
+    typedef QHash<QString, Entry> Entries;
+
+    explicit ROSPackageInfoCache(QObject *parent = nullptr);
+
+    /** @brief Get a snapshot of the cached entries */
+    Entries entries() const;
+
+    /**
+     * @brief Bring the entry of a package up to date
+     * @param packagePath The package directory
+     * @param previous The cached entry of the package, nullptr if there is none
+     * @param environment The environment conditions are evaluated in
+     * @param entry The up to date entry, a copy of previous if the manifest can not be read or parsed
+     * @param diagnostics Warnings and errors of the parser are appended, only if the manifest is parsed again
+     * @return False if the manifest can not be read or parsed, otherwise true
+     */
+    static bool refresh(const QString &packagePath, const Entry *previous, const Utils::Environment &environment, Entry &entry, QStringList &diagnostics);
+
+    /**
+     * @brief Replace the cached entries, emits packagesInvalidated() if a package changed
+     *
+     * The canceled function is checked while the cache is locked. An update that is canceled
+     * before a newer one starts therefore can never replace the entries of the newer one.
+     *
+     * @param entries The entries of all workspace packages
+     * @param isCanceled Optional, if it returns true the entries are dropped
+     * @return False if the update was canceled, otherwise true
+     */
+    bool commit(const Entries &entries, const std::function<bool()> &isCanceled = std::function<bool()>());
+
+signals:
+    /**
+     * @brief Emitted from the thread calling commit() if packages changed
+     * @param changed Directories of packages whose information changed or that were added
+     * @param removed Directories of packages that were removed
+     */
+    void packagesInvalidated(const QStringList &changed, const QStringList &removed);
+
+private:
+    mutable QMutex m_mutex;
+    Entries m_entries;
+};
+
+} // namespace Internal
+} // namespace ROSProjectManager
+
+#endif // ROS_PACKAGE_INFO_CACHE_H
@@ -20,193 +20,452 @@
  */
 
 #include "ros_packagexml_parser.h"
-#include <coreplugin/messagemanager.h>
+#include <QBuffer>
 #include <QFile>
+#include <QHash>
+#include <QObject>
 #include <QDebug>
 
 namespace ROSProjectManager {
 namespace Internal {
 
-bool ROSPackageXmlParser::parsePackageXml(const Utils::FilePath &filepath)
+/**
+ * @brief Recursive descent evaluator for package format 3 conditions.
+ *
+ * condition  := or
+ * or         := and ("or" and)*
+ * and        := comparison ("and" comparison)*
+ * comparison := "(" or ")" | value operator value
+ * value      := $VARIABLE | 'quoted' | "quoted" | literal
+ * operator   := == | != | < | <= | > | >=
+ */
+class ROSPackageConditionEvaluator
 {
-    m_packageInfo.path = filepath.parentDir();
-    m_packageInfo.filepath = filepath;
-    m_packageInfo.buildFile = m_packageInfo.path.pathAppended("CMakeLists.txt");
+public:
+    ROSPackageConditionEvaluator(QStringView condition,
+                                 const Utils::Environment &environment,
+                                 ROSPackageXmlParser::ConditionVariables *variables) :
+        m_text(condition),
+        m_pos(0),
+        m_environment(environment),
+        m_variables(variables),
+        m_unset(false)
+    {
+    }
 
-    QFile pkgFile(filepath.toString());
-    if (pkgFile.exists() && pkgFile.open(QFile::ReadOnly)) {
-        setDevice(&pkgFile);
+    bool evaluate(bool &result)
+    {
+        if (!parseOr(result))
+            return false;
+
+        skipSpace();
+        return m_pos == m_text.size();
+    }
+
+    /** @brief True if the condition referred to a variable that is not set */
+    bool hasUnsetVariable() const { return m_unset; }
+
+private:
+    bool parseOr(bool &result)
+    {
+        if (!parseAnd(result))
+            return false;
 
-        while (!atEnd()) {
-            readNext();
-            if (name().toString() == "package")
-                parse();
-            else if (isStartElement())
-                parseUnknownElement();
+        while (consumeKeyword(u"or"))
+        {
+            bool rhs = false;
+            if (!parseAnd(rhs))
+                return false;
+
+            result = result || rhs;
         }
+        return true;
+    }
 
-        pkgFile.close();
+    bool parseAnd(bool &result)
+    {
+        if (!parseComparison(result))
+            return false;
+
+        while (consumeKeyword(u"and"))
+        {
+            bool rhs = false;
+            if (!parseComparison(rhs))
+                return false;
+
+            result = result && rhs;
+        }
         return true;
     }
 
-    Core::MessageManager::writeFlashing(QObject::tr("[ROS Error] Failed to parse file: %1.").arg(m_packageInfo.filepath.toString()));
-    return false;
-}
+    bool parseComparison(bool &result)
+    {
+        skipSpace();
+        if (m_pos < m_text.size() && m_text.at(m_pos) == QLatin1Char('('))
+        {
+            ++m_pos;
+            if (!parseOr(result))
+                return false;
+
+            skipSpace();
+            if (m_pos >= m_text.size() || m_text.at(m_pos) != QLatin1Char(')'))
+                return false;
+
+            ++m_pos;
+            return true;
+        }
 
-bool ROSPackageXmlParser::parsePackageXml(const Utils::FilePath &filepath, ROSUtils::PackageInfo &packageInfo)
-{
-    bool result = parsePackageXml(filepath);
-    packageInfo = m_packageInfo;
-    return result;
-}
+        QString lhs, rhs;
+        QStringView op;
+        if (!parseValue(lhs) || !parseOperator(op) || !parseValue(rhs))
+            return false;
+
+        const int order = lhs.compare(rhs);
+        if (op == u"==")
+            result = order == 0;
+        else if (op == u"!=")
+            result = order != 0;
+        else if (op == u"<")
+            result = order < 0;
+        else if (op == u"<=")
+            result = order <= 0;
+        else if (op == u">")
+            result = order > 0;
+        else
+            result = order >= 0;
 
-void ROSPackageXmlParser::parse()
-{
-    while (!atEnd()) {
-        readNext();
-        if (isEndElement())
-            return;
-        else if (name().toString() == "name")
-            parseName();
-        else if (name().toString() == "version")
-            parseVersion();
-        else if (name().toString() == "description")
-            parseDescription();
-        else if (name().toString() == "maintainer")
-            parseMaintainer();
-        else if (name().toString() == "license")
-            parseLicense();
-        else if (name().toString() == "depend")
-            parseDepend();
-        else if (name().toString() == "build_depend")
-            parseBuildDepend();
-        else if (name().toString() == "buildtool_depend")
-            parseBuildToolDepend();
-        else if (name().toString() == "build_export_depend")
-            parseBuildExportDepend();
-        else if (name().toString() == "exec_depend")
-            parseExecDepend();
-        else if (name().toString() == "run_depend")
-            parseExecDepend();
-        else if (name().toString() == "test_depend")
-            parseTestDepend();
-        else if (name().toString() == "doc_depend")
-            parseDocDepend();
-        else if (name().toString() == "export")
-            parseExport();
-        else if (isStartElement())
-            parseUnknownElement();
+        return true;
     }
-}
 
-void ROSPackageXmlParser::parseName()
-{
-    m_packageInfo.name = readElementText().trimmed();
-}
+    bool parseValue(QString &value)
+    {
+        skipSpace();
+        if (m_pos >= m_text.size())
+            return false;
+
+        const QChar first = m_text.at(m_pos);
+        if (first == QLatin1Char('$'))
+        {
+            const qsizetype start = ++m_pos;
+            while (m_pos < m_text.size() && (m_text.at(m_pos).isLetterOrNumber() || m_text.at(m_pos) == QLatin1Char('_')))
+                ++m_pos;
+
+            if (m_pos == start)
+                return false;
+
+            const QString name = m_text.mid(start, m_pos - start).toString();
+            const std::optional<QString> variable = ROSPackageXmlParser::conditionVariable(m_environment, name);
+            if (m_variables)
+                m_variables->insert(name, variable);
+
+            m_unset = m_unset || !variable;
+            value = variable.value_or(QString());
+            return true;
+        }
+
+        if (first == QLatin1Char('"') || first == QLatin1Char('\''))
+        {
+            const qsizetype end = m_text.indexOf(first, m_pos + 1);
+            if (end < 0)
+                return false;
+
+            value = m_text.mid(m_pos + 1, end - m_pos - 1).toString();
+            m_pos = end + 1;
+            return true;
+        }
+
+        const qsizetype start = m_pos;
+        while (m_pos < m_text.size() && !m_text.at(m_pos).isSpace() && !isOperatorOrParenthesis(m_text.at(m_pos)))
+            ++m_pos;
+
+        value = m_text.mid(start, m_pos - start).toString();
+        return m_pos > start;
+    }
+
+    bool parseOperator(QStringView &op)
+    {
+        skipSpace();
+        const qsizetype start = m_pos;
+        while (m_pos < m_text.size() && m_pos - start < 2 && isOperatorOrParenthesis(m_text.at(m_pos))
+               && m_text.at(m_pos) != QLatin1Char('(') && m_text.at(m_pos) != QLatin1Char(')'))
+            ++m_pos;
+
+        op = m_text.mid(start, m_pos - start);
+        return op == u"==" || op == u"!=" || op == u"<" || op == u"<=" || op == u">" || op == u">=";
+    }
+
+    bool consumeKeyword(QStringView keyword)
+    {
+        skipSpace();
+        const QStringView rest = m_text.mid(m_pos);
+        if (!rest.startsWith(keyword))
+            return false;
+
+        // The keyword must not be the start of a longer word
+        if (rest.size() > keyword.size() && !rest.at(keyword.size()).isSpace() && rest.at(keyword.size()) != QLatin1Char('('))
+            return false;
 
-void ROSPackageXmlParser::parseVersion()
+        m_pos += keyword.size();
+        return true;
+    }
+
+    void skipSpace()
+    {
+        while (m_pos < m_text.size() && m_text.at(m_pos).isSpace())
+            ++m_pos;
+    }
+
+    static bool isOperatorOrParenthesis(QChar c)
+    {
+        return c == QLatin1Char('=') || c == QLatin1Char('!') || c == QLatin1Char('<') || c == QLatin1Char('>')
+               || c == QLatin1Char('(') || c == QLatin1Char(')');
+    }
+
+    QStringView m_text;
+    qsizetype m_pos;
+    const Utils::Environment &m_environment;
+    ROSPackageXmlParser::ConditionVariables *m_variables;
+    bool m_unset;
+};
+
+ROSPackageXmlParser::Tag ROSPackageXmlParser::tag(QStringView name)
 {
-    m_packageInfo.version = readElementText().trimmed();
+    // The keys point to string literals, so lookups never allocate
+    static const QHash<QStringView, Tag> tags = {
+        {u"name", Tag::Name},
+        {u"version", Tag::Version},
+        {u"description", Tag::Description},
+        {u"maintainer", Tag::Maintainer},
+        {u"license", Tag::License},
+        {u"depend", Tag::Depend},
+        {u"build_depend", Tag::BuildDepend},
+        {u"buildtool_depend", Tag::BuildToolDepend},
+        {u"build_export_depend", Tag::BuildExportDepend},
+        {u"exec_depend", Tag::ExecDepend},
+        {u"run_depend", Tag::ExecDepend},
+        {u"test_depend", Tag::TestDepend},
+        {u"doc_depend", Tag::DocDepend},
+        {u"export", Tag::Export},
+        {u"metapackage", Tag::Metapackage}
+    };
+
+    return tags.value(name, Tag::Unknown);
 }
 
-void ROSPackageXmlParser::parseDescription()
+void ROSPackageXmlParser::setEnvironment(const Utils::Environment &environment)
 {
-    m_packageInfo.description = readElementText().trimmed();
+    m_environment = environment;
 }
 
-void ROSPackageXmlParser::parseMaintainer()
+std::optional<QString> ROSPackageXmlParser::conditionVariable(const Utils::Environment &environment, const QString &name)
 {
-    m_packageInfo.maintainer = readElementText().trimmed();
+    if (!environment.hasKey(name))
+        return std::nullopt;
+
+    return environment.value(name);
 }
 
-void ROSPackageXmlParser::parseLicense()
+bool ROSPackageXmlParser::evaluateCondition(QStringView condition, const Utils::Environment &environment, bool *ok, ConditionVariables *variables)
 {
-    m_packageInfo.license = readElementText().trimmed();
+    bool result = true;
+    ROSPackageConditionEvaluator evaluator(condition, environment, variables);
+    const bool valid = evaluator.evaluate(result);
+    if (ok)
+        *ok = valid;
+
+    // The IDE may not run in a sourced shell, an unknown variable must not drop the element
+    if (!valid || evaluator.hasUnsetVariable())
+        return true;
+
+    return result;
 }
 
-void ROSPackageXmlParser::parseDepend()
+bool ROSPackageXmlParser::parsePackageXml(const Utils::FilePath &filepath)
 {
-    QString value = readElementText().trimmed();
-    if (!m_packageInfo.buildDepends.contains(value))
-        m_packageInfo.buildDepends.push_back(value);
+    reset(filepath);
 
-    if (!m_packageInfo.buildExportDepends.contains(value))
-        m_packageInfo.buildExportDepends.push_back(value);
+    QFile pkgFile(filepath.toString());
+    if (pkgFile.exists() && pkgFile.open(QFile::ReadOnly)) {
+        setDevice(&pkgFile);
+        parseDocument();
+        setDevice(nullptr);
+        pkgFile.close();
+        return true;
+    }
 
-    if (!m_packageInfo.execDepends.contains(value))
-        m_packageInfo.execDepends.push_back(value);
+    return false;
 }
 
-void ROSPackageXmlParser::parseBuildDepend()
+bool ROSPackageXmlParser::parsePackageXml(const Utils::FilePath &filepath, ROSUtils::PackageInfo &packageInfo)
 {
-    QString value = readElementText().trimmed();
-    if (!m_packageInfo.buildDepends.contains(value))
-        m_packageInfo.buildDepends.push_back(value);
+    bool result = parsePackageXml(filepath);
+    packageInfo = m_packageInfo;
+    return result;
 }
 
-void ROSPackageXmlParser::parseBuildToolDepend()
+bool ROSPackageXmlParser::parsePackageXml(const Utils::FilePath &filepath, const QByteArray &content, ROSUtils::PackageInfo &packageInfo)
 {
-    m_packageInfo.buildToolDepend = readElementText().trimmed();
-}
+    reset(filepath);
 
-void ROSPackageXmlParser::parseBuildExportDepend()
-{
-    QString value = readElementText().trimmed();
-    if (!m_packageInfo.buildExportDepends.contains(value))
-        m_packageInfo.buildExportDepends.push_back(value);
+    QBuffer buffer;
+    buffer.setData(content);
+    buffer.open(QIODevice::ReadOnly);
+    setDevice(&buffer);
+    parseDocument();
+    setDevice(nullptr);
+
+    if (hasError())
+        m_diagnostics.append(QObject::tr("[ROS Error] %1 in file: %2, line %3.").arg(errorString(), filepath.toString()).arg(lineNumber()));
+    else if (m_packageInfo.name.isEmpty())
+        m_diagnostics.append(QObject::tr("[ROS Error] Missing package name in file: %1.").arg(filepath.toString()));
+
+    packageInfo = m_packageInfo;
+    return !hasError() && !m_packageInfo.name.isEmpty();
 }
 
-void ROSPackageXmlParser::parseExecDepend()
+void ROSPackageXmlParser::reset(const Utils::FilePath &filepath)
 {
-    QString value = readElementText().trimmed();
-    if (!m_packageInfo.execDepends.contains(value))
-        m_packageInfo.execDepends.push_back(value);
+    m_packageInfo = ROSUtils::PackageInfo();
+    m_diagnostics.clear();
+    m_conditionVariables.clear();
+    m_buildDepends.clear();
+    m_buildExportDepends.clear();
+    m_execDepends.clear();
+    m_testDepends.clear();
+    m_docDepends.clear();
+
+    m_packageInfo.path = filepath.parentDir();
+    m_packageInfo.filepath = filepath;
+    m_packageInfo.buildFile = m_packageInfo.path.pathAppended("CMakeLists.txt");
 }
 
-void ROSPackageXmlParser::parseTestDepend()
+void ROSPackageXmlParser::parseDocument()
 {
-    QString value = readElementText().trimmed();
-    if (!m_packageInfo.testDepends.contains(value))
-        m_packageInfo.testDepends.push_back(value);
+    while (!atEnd()) {
+        readNext();
+        if (!isStartElement())
+            continue;
+
+        if (name() == u"package")
+            parse();
+        else
+            parseUnknownElement();
+    }
 }
 
-void ROSPackageXmlParser::parseDocDepend()
+bool ROSPackageXmlParser::isConditionMet()
 {
-    QString value = readElementText().trimmed();
-    if (!m_packageInfo.docDepends.contains(value))
-        m_packageInfo.docDepends.push_back(value);
+    const QStringView condition = attributes().value(QLatin1String("condition"));
+    if (condition.isEmpty())
+        return true;
+
+    bool ok = true;
+    const bool result = evaluateCondition(condition, m_environment, &ok, &m_conditionVariables);
+    if (!ok)
+        m_diagnostics.append(QObject::tr("[ROS Warning] Invalid condition \"%1\" in file: %2.").arg(condition.toString(), m_packageInfo.filepath.toString()));
+
+    return result;
 }
 
-void ROSPackageXmlParser::parseExport()
+void ROSPackageXmlParser::parse()
 {
     while (!atEnd()) {
         readNext();
         if (isEndElement())
             return;
-        else if (name().toString() == "metapackage")
-            parseMetapackage();
-        else if (isStartElement())
+
+        if (!isStartElement())
+            continue;
+
+        const Tag elementTag = tag(name());
+        if (elementTag == Tag::Unknown || !isConditionMet())
+        {
+            parseUnknownElement();
+            continue;
+        }
+
+        switch (elementTag)
+        {
+        case Tag::Name:
+            m_packageInfo.name = readElementText().trimmed();
+            break;
+        case Tag::Version:
+            m_packageInfo.version = readElementText().trimmed();
+            break;
+        case Tag::Description:
+            m_packageInfo.description = readElementText(IncludeChildElements).trimmed();
+            break;
+        case Tag::Maintainer:
+            m_packageInfo.maintainer = readElementText().trimmed();
+            break;
+        case Tag::License:
+            m_packageInfo.license = readElementText().trimmed();
+            break;
+        case Tag::Depend:
+        {
+            const QString value = readElementText().trimmed();
+            addDepend(m_packageInfo.buildDepends, m_buildDepends, value);
+            addDepend(m_packageInfo.buildExportDepends, m_buildExportDepends, value);
+            addDepend(m_packageInfo.execDepends, m_execDepends, value);
+            break;
+        }
+        case Tag::BuildDepend:
+            addDepend(m_packageInfo.buildDepends, m_buildDepends, readElementText().trimmed());
+            break;
+        case Tag::BuildToolDepend:
+            m_packageInfo.buildToolDepend = readElementText().trimmed();
+            break;
+        case Tag::BuildExportDepend:
+            addDepend(m_packageInfo.buildExportDepends, m_buildExportDepends, readElementText().trimmed());
+            break;
+        case Tag::ExecDepend:
+            addDepend(m_packageInfo.execDepends, m_execDepends, readElementText().trimmed());
+            break;
+        case Tag::TestDepend:
+            addDepend(m_packageInfo.testDepends, m_testDepends, readElementText().trimmed());
+            break;
+        case Tag::DocDepend:
+            addDepend(m_packageInfo.docDepends, m_docDepends, readElementText().trimmed());
+            break;
+        case Tag::Export:
+            parseExport();
+            break;
+        default:
             parseUnknownElement();
+            break;
+        }
     }
 }
 
-void ROSPackageXmlParser::parseMetapackage()
+void ROSPackageXmlParser::parseExport()
 {
-    m_packageInfo.metapackage = true;
+    while (!atEnd()) {
+        readNext();
+        if (isEndElement())
+            return;
+
+        if (!isStartElement())
+            continue;
+
+        if (tag(name()) == Tag::Metapackage && isConditionMet())
+            m_packageInfo.metapackage = true;
+
+        parseUnknownElement();
+    }
 }
 
 void ROSPackageXmlParser::parseUnknownElement()
 {
     Q_ASSERT(isStartElement());
+    skipCurrentElement();
+}
 
-    while (!atEnd()) {
-        readNext();
-
-        if (isEndElement())
-            break;
-
-        if (isStartElement())
-            parseUnknownElement();
+void ROSPackageXmlParser::addDepend(QStringList &depends, QSet<QString> &seen, const QString &value)
+{
+    if (!value.isEmpty() && !seen.contains(value))
+    {
+        seen.insert(value);
+        depends.push_back(value);
     }
 }
 
@@ -215,6 +474,16 @@ ROSUtils::PackageInfo ROSPackageXmlParser::getInfo() const
     return m_packageInfo;
 }
 
+ROSPackageXmlParser::ConditionVariables ROSPackageXmlParser::conditionVariables() const
+{
+    return m_conditionVariables;
+}
+
+QStringList ROSPackageXmlParser::diagnostics() const
+{
+    return m_diagnostics;
+}
+
 
 } // namespace Internal
 } // namespace ROSProjectManager
@@ -23,46 +23,132 @@
 
 #include "ros_utils.h"
 
+#include <utils/environment.h>
+
+#include <QMap>
+#include <QSet>
 #include <QString>
+#include <QStringView>
 #include <QXmlStreamReader>
 
+#include <optional>
+
 namespace ROSProjectManager {
 namespace Internal {
 
+/**
+ * @brief Parser for package.xml files of format 1, 2 and 3.
+ *
+ * Elements are dispatched through a precomputed tag table on the element name as returned
+ * by the reader, so no string is allocated per element. Elements with a format 3 condition
+ * attribute that evaluates to false are skipped. Variables in conditions are taken from the
+ * environment set with setEnvironment(). A condition referring to a variable that is not set
+ * is treated as met, so an incomplete environment never drops a dependency.
+ *
+ * The parser never writes to the message manager, so it may be used from any thread.
+ */
 class ROSPackageXmlParser : public QXmlStreamReader
 {
 public:
+    /** @brief Variable name, value, std::nullopt if the variable is not set */
+    typedef QMap<QString, std::optional<QString>> ConditionVariables;
+
     ROSPackageXmlParser() {}
 
+    /**
+     * @brief Set the environment conditions are evaluated in, by default no variable is set
+     * @param environment The workspace build environment
+     */
+    void setEnvironment(const Utils::Environment &environment);
+
     bool parsePackageXml(const Utils::FilePath &filepath);
 
     bool parsePackageXml(const Utils::FilePath &filepath,
                          ROSUtils::PackageInfo &packageInfo);
 
+    /**
+     * @brief Parse a package.xml that was already read
+     * @param filepath Path of the package.xml, used for the package paths
+     * @param content The content of the package.xml
+     * @param packageInfo The parsed package information
+     * @return True if the document is well-formed and names the package, otherwise false and the
+     *         XML error is added to the diagnostics
+     */
+    bool parsePackageXml(const Utils::FilePath &filepath,
+                         const QByteArray &content,
+                         ROSUtils::PackageInfo &packageInfo);
+
     ROSUtils::PackageInfo getInfo() const;
 
+    /** @brief Get the warnings and errors of the last parse, e.g. invalid conditions */
+    QStringList diagnostics() const;
+
+    /** @brief Get the variables the conditions of the last parse referred to */
+    ConditionVariables conditionVariables() const;
+
+    /**
+     * @brief Get the value of a condition variable
+     * @param environment The environment
+     * @param name The variable name
+     * @return The value, std::nullopt if the variable is not set
+     */
+    static std::optional<QString> conditionVariable(const Utils::Environment &environment, const QString &name);
+
+    /**
+     * @brief Evaluate a format 3 condition attribute (REP 149)
+     * @param condition The condition, e.g. "$ROS_VERSION == 2 and $ROS_DISTRO != foxy"
+     * @param environment The environment the variables are taken from
+     * @param ok If not nullptr, set to false if the condition is malformed
+     * @param variables If not nullptr, the referenced variables are added
+     * @return The result of the condition, true for malformed conditions and conditions referring to unset variables
+     */
+    static bool evaluateCondition(QStringView condition,
+                                  const Utils::Environment &environment,
+                                  bool *ok = nullptr,
+                                  ConditionVariables *variables = nullptr);
+
 private:
-    void parse();
-    void parseName();
-    void parseVersion();
-    void parseDescription();
-    void parseMaintainer();
-    void parseLicense();
-
-    void parseDepend();
-    void parseBuildDepend();
-    void parseBuildToolDepend();
-    void parseBuildExportDepend();
-    void parseExecDepend();
-    void parseTestDepend();
-    void parseDocDepend();
+    enum class Tag
+    {
+        Unknown,
+        Name,
+        Version,
+        Description,
+        Maintainer,
+        License,
+        Depend,
+        BuildDepend,
+        BuildToolDepend,
+        BuildExportDepend,
+        ExecDepend,
+        TestDepend,
+        DocDepend,
+        Export,
+        Metapackage
+    };
 
-    void parseExport();
-    void parseMetapackage();
+    static Tag tag(QStringView name);
+
+    void reset(const Utils::FilePath &filepath);
+    void parseDocument();
 
+    bool isConditionMet();
+    void parse();
+    void parseExport();
     void parseUnknownElement();
+    void addDepend(QStringList &depends, QSet<QString> &seen, const QString &value);
 
     ROSUtils::PackageInfo m_packageInfo;
+    QStringList m_diagnostics;
+    Utils::Environment m_environment;
+    ConditionVariables m_conditionVariables;
+
+    // Used to drop duplicate dependencies without searching the lists
+    QSet<QString> m_buildDepends;
+    QSet<QString> m_buildExportDepends;
+    QSet<QString> m_execDepends;
+    QSet<QString> m_testDepends;
+    QSet<QString> m_docDepends;
 };
 } // namespace Internal
 } // namespace ROSProjectManager
@@ -0,0 +1,307 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ros_path_filter.h"
+#include "ros_project_plugin.h"
+#include "ros_settings_page.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+
+namespace ROSProjectManager {
+namespace Internal {
+
+// Expression that never matches, used when there are no filters at all
+static const char NEVER_MATCH[] = "(?!)";
+
+/**
+ * @brief Convert a .gitignore pattern to an anchored regular expression
+ *
+ * '*' and '?' do not match '/', '**' matches across directories.
+ */
+static QString gitignorePatternToRegularExpression(const QString &pattern)
+{
+    QString rx;
+    const int size = static_cast<int>(pattern.size());
+    for (int i = 0; i < size; ++i)
+    {
+        const QChar c = pattern.at(i);
+        if (c == QLatin1Char('*'))
+        {
+            if (i + 1 < size && pattern.at(i + 1) == QLatin1Char('*'))
+            {
+                if (i + 2 < size && pattern.at(i + 2) == QLatin1Char('/'))
+                {
+                    rx += QLatin1String("(?:.*/)?");
+                    i += 2;
+                }
+                else
+                {
+                    rx += QLatin1String(".*");
+                    i += 1;
+                }
+            }
+            else
+            {
+                rx += QLatin1String("[^/]*");
+            }
+        }
+        else if (c == QLatin1Char('?'))
+        {
+            rx += QLatin1String("[^/]");
+        }
+        else if (c == QLatin1Char('['))
+        {
+            const int end = static_cast<int>(pattern.indexOf(QLatin1Char(']'), i + 2));
+            if (end < 0)
+            {
+                rx += QLatin1String("\\[");
+                continue;
+            }
+
+            QString set = pattern.mid(i + 1, end - i - 1);
+            if (set.startsWith(QLatin1Char('!')))
+                set[0] = QLatin1Char('^');
+
+            set.replace(QLatin1Char('\\'), QLatin1String("\\\\"));
+            rx += QLatin1Char('[') + set + QLatin1Char(']');
+            i = end;
+        }
+        else if (c == QLatin1Char('\\') && i + 1 < size)
+        {
+            rx += QRegularExpression::escape(pattern.mid(++i, 1));
+        }
+        else
+        {
+            rx += QRegularExpression::escape(QString(c));
+        }
+    }
+
+    return QLatin1String("\\A") + rx + QLatin1String("\\z");
+}
+
+ROSPathFilter::ROSPathFilter()
+{
+    QStringList folderNameFilters, fileNameFilters;
+    ROSUtils::getDefaultFolderContentFilters(folderNameFilters, fileNameFilters);
+    compile(folderNameFilters, fileNameFilters, QStringList());
+}
+
+ROSPathFilter::ROSPathFilter(const QStringList &excludePatterns)
+{
+    QStringList folderNameFilters, fileNameFilters;
+    ROSUtils::getDefaultFolderContentFilters(folderNameFilters, fileNameFilters);
+    compile(folderNameFilters, fileNameFilters, excludePatterns);
+}
+
+ROSPathFilter ROSPathFilter::fromSettings()
+{
+    return ROSPathFilter(ROSProjectPlugin::instance()->settings()->exclude_patterns);
+}
+
+void ROSPathFilter::compile(const QStringList &folderNameFilters,
+                            const QStringList &fileNameFilters,
+                            const QStringList &excludePatterns)
+{
+    QStringList directoryParts, fileParts;
+    for (const QString &filter : folderNameFilters)
+        directoryParts.append(QLatin1String("(?:") + filter + QLatin1Char(')'));
+
+    for (const QString &filter : fileNameFilters)
+        fileParts.append(QLatin1String("(?:") + filter + QLatin1Char(')'));
+
+    for (const QString &pattern : excludePatterns)
+    {
+        const QString rx = QLatin1String("(?:") + QRegularExpression::wildcardToRegularExpression(pattern) + QLatin1Char(')');
+        directoryParts.append(rx);
+        fileParts.append(rx);
+    }
+
+    m_directoryExpression.setPattern(directoryParts.isEmpty() ? QString::fromLatin1(NEVER_MATCH) : directoryParts.join(QLatin1Char('|')));
+    m_fileExpression.setPattern(fileParts.isEmpty() ? QString::fromLatin1(NEVER_MATCH) : fileParts.join(QLatin1Char('|')));
+    m_directoryExpression.optimize();
+    m_fileExpression.optimize();
+}
+
+bool ROSPathFilter::isIgnoreMarker(const QString &fileName)
+{
+    return fileName == QLatin1String("CATKIN_IGNORE")
+           || fileName == QLatin1String("COLCON_IGNORE")
+           || fileName == QLatin1String("AMENT_IGNORE");
+}
+
+bool ROSPathFilter::containsIgnoreMarker(const QString &directory)
+{
+    for (const char *marker : {"/CATKIN_IGNORE", "/COLCON_IGNORE", "/AMENT_IGNORE"})
+    {
+        if (QFileInfo::exists(directory + QLatin1String(marker)))
+            return true;
+    }
+
+    return false;
+}
+
+void ROSPathFilter::removeIgnoredDirectories(const QString &directory, ROSUtils::FolderContent &content)
+{
+    const QString prefix = directory + QLatin1Char('/');
+    content.directories.removeIf([&prefix](const QString &name) { return containsIgnoreMarker(prefix + name); });
+}
+
+bool ROSPathFilter::isDirectoryExcluded(const QString &name) const
+{
+    return m_directoryExpression.match(name).hasMatch();
+}
+
+bool ROSPathFilter::isFileExcluded(const QString &name) const
+{
+    return m_fileExpression.match(name).hasMatch();
+}
+
+bool ROSPathFilter::apply(const QString &directory, ROSUtils::FolderContent &content, ScopePtr &scope) const
+{
+    // The build tools skip the whole subtree, so never walk into it
+    for (const QString &file : std::as_const(content.files))
+    {
+        if (isIgnoreMarker(file))
+        {
+            content.files.clear();
+            content.directories.clear();
+            return false;
+        }
+    }
+
+    if (content.files.contains(QLatin1String(".gitignore")))
+        scope = Scope::load(directory, scope);
+
+    const QString prefix = directory + QLatin1Char('/');
+    content.directories.removeIf([&](const QString &name) {
+        return isDirectoryExcluded(name) || (scope && scope->isIgnored(prefix + name, true));
+    });
+
+    content.files.removeIf([&](const QString &name) {
+        return isFileExcluded(name) || (scope && scope->isIgnored(prefix + name, false));
+    });
+
+    return true;
+}
+
+ROSPathFilter::ScopePtr ROSPathFilter::parentScope(const QString &root, const QString &directory) const
+{
+    ScopePtr scope;
+    if (!directory.startsWith(root))
+        return scope;
+
+    const QStringList parts = directory.mid(root.size()).split(QLatin1Char('/'), Qt::SkipEmptyParts);
+    QString current = root;
+    for (const QString &part : parts)
+    {
+        if (QFileInfo::exists(current + QLatin1String("/.gitignore")))
+            scope = Scope::load(current, scope);
+
+        current += QLatin1Char('/') + part;
+    }
+
+    return scope;
+}
+
+ROSPathFilter::ScopePtr ROSPathFilter::Scope::load(const QString &directory, const ScopePtr &parent)
+{
+    QFile file(directory + QLatin1String("/.gitignore"));
+    if (!file.open(QFile::ReadOnly | QFile::Text))
+        return parent;
+
+    auto scope = std::make_shared<Scope>();
+    scope->m_parent = parent;
+    scope->m_directory = directory;
+
+    QTextStream stream(&file);
+    while (!stream.atEnd())
+    {
+        QString line = stream.readLine();
+
+        // Trailing spaces are ignored unless escaped
+        while (line.endsWith(QLatin1Char(' ')) && !line.endsWith(QLatin1String("\\ ")))
+            line.chop(1);
+
+        if (line.isEmpty() || line.startsWith(QLatin1Char('#')))
+            continue;
+
+        Rule rule;
+        if (line.startsWith(QLatin1Char('!')))
+        {
+            rule.negated = true;
+            line.remove(0, 1);
+        }
+        else if (line.startsWith(QLatin1String("\\!")) || line.startsWith(QLatin1String("\\#")))
+        {
+            line.remove(0, 1);
+        }
+
+        if (line.endsWith(QLatin1Char('/')))
+        {
+            rule.directoryOnly = true;
+            line.chop(1);
+        }
+
+        // A slash at the beginning or in the middle anchors the pattern to this directory
+        rule.matchName = !line.contains(QLatin1Char('/'));
+        if (line.startsWith(QLatin1Char('/')))
+            line.remove(0, 1);
+
+        if (line.isEmpty())
+            continue;
+
+        rule.expression.setPattern(gitignorePatternToRegularExpression(line));
+        if (!rule.expression.isValid())
+            continue;
+
+        rule.expression.optimize();
+        scope->m_rules.append(rule);
+    }
+
+    if (scope->m_rules.isEmpty())
+        return parent;
+
+    return scope;
+}
+
+bool ROSPathFilter::Scope::isIgnored(const QString &path, bool isDirectory) const
+{
+    // Deeper .gitignore files take precedence and within a file the last matching rule wins
+    for (const Scope *scope = this; scope; scope = scope->m_parent.get())
+    {
+        const QString relative = path.mid(scope->m_directory.size() + 1);
+        const QString name = relative.mid(relative.lastIndexOf(QLatin1Char('/')) + 1);
+        for (auto it = scope->m_rules.crbegin(); it != scope->m_rules.crend(); ++it)
+        {
+            if (it->directoryOnly && !isDirectory)
+                continue;
+
+            if (it->expression.match(it->matchName ? name : relative).hasMatch())
+                return !it->negated;
+        }
+    }
+
+    return false;
+}
+
+} // namespace Internal
+} // namespace ROSProjectManager
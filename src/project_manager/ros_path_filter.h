@@ -0,0 +1,176 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ROS_PATH_FILTER_H
+#define ROS_PATH_FILTER_H
+
+#include "ros_utils.h"
+
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <memory>
+
+namespace ROSProjectManager {
+namespace Internal {
+
+/**
+ * @brief Precompiled filter deciding which workspace files and directories are scanned.
+ *
+ * The default folder content filters and the user exclude patterns are compiled once
+ * into a single expression for directories and one for files. In addition directories
+ * containing a CATKIN_IGNORE, COLCON_IGNORE or AMENT_IGNORE marker are not entered and
+ * .gitignore files are honoured for the directory they are in and its subdirectories.
+ *
+ * A filter is immutable once created and may be shared by several threads.
+ */
+class ROSPathFilter
+{
+public:
+    class Scope;
+
+    /** @brief The .gitignore rules in effect for a directory, nullptr if there are none */
+    typedef std::shared_ptr<const Scope> ScopePtr;
+
+    /** @brief Create a filter using the default folder content filters */
+    ROSPathFilter();
+
+    /**
+     * @brief Create a filter using the default folder content filters and user exclude patterns
+     * @param excludePatterns Wildcard patterns matched against file and directory names
+     */
+    explicit ROSPathFilter(const QStringList &excludePatterns);
+
+    /**
+     * @brief Create a filter using the default folder content filters and the exclude patterns from the ROS settings
+     * @note Must be called from the GUI thread.
+     * @return The filter
+     */
+    static ROSPathFilter fromSettings();
+
+    /**
+     * @brief Check if a file marks its directory as ignored by the build tools
+     * @param fileName The file name
+     * @return True if the file is CATKIN_IGNORE, COLCON_IGNORE or AMENT_IGNORE
+     */
+    static bool isIgnoreMarker(const QString &fileName);
+
+    /**
+     * @brief Check if a directory contains an ignore marker, see isIgnoreMarker()
+     * @param directory Path to the directory
+     * @return True if the build tools skip the directory
+     */
+    static bool containsIgnoreMarker(const QString &directory);
+
+    /**
+     * @brief Remove the subdirectories containing an ignore marker from a directory listing.
+     *
+     * The walk drops ignored directories once they are read, this is for listings whose
+     * subdirectories are not read, e.g. when a single directory changed.
+     *
+     * @param directory Path to the directory
+     * @param content The content of the directory, filtered in place
+     */
+    static void removeIgnoredDirectories(const QString &directory, ROSUtils::FolderContent &content);
+
+    /**
+     * @brief Check if a directory name is excluded by the name filters
+     * @param name The directory name
+     * @return True if excluded, otherwise false
+     */
+    bool isDirectoryExcluded(const QString &name) const;
+
+    /**
+     * @brief Check if a file name is excluded by the name filters
+     * @param name The file name
+     * @return True if excluded, otherwise false
+     */
+    bool isFileExcluded(const QString &name) const;
+
+    /**
+     * @brief Filter the unfiltered content of a directory.
+     *
+     * If the directory contains an ignore marker its content is cleared so its subtree
+     * is never entered, the caller removes it from the listing of its parent. If it contains
+     * a .gitignore file the returned scope includes its rules.
+     *
+     * @param directory Path to the directory
+     * @param content The unfiltered content of the directory, filtered in place
+     * @param scope The scope of the parent directory, replaced with the scope of this directory
+     * @return False if the directory is ignored, otherwise true
+     */
+    bool apply(const QString &directory, ROSUtils::FolderContent &content, ScopePtr &scope) const;
+
+    /**
+     * @brief Get the scope of the parent of a directory by reading the .gitignore files from the root down
+     * @param root The root directory of the scan
+     * @param directory The directory
+     * @return The scope to pass to apply() for the directory
+     */
+    ScopePtr parentScope(const QString &root, const QString &directory) const;
+
+private:
+    void compile(const QStringList &folderNameFilters,
+                 const QStringList &fileNameFilters,
+                 const QStringList &excludePatterns);
+
+    QRegularExpression m_directoryExpression;
+    QRegularExpression m_fileExpression;
+};
+
+/** @brief The rules of all .gitignore files from the scan root down to a directory */
+class ROSPathFilter::Scope
+{
+public:
+    /**
+     * @brief Parse a .gitignore file
+     * @param directory The directory containing the .gitignore file
+     * @param parent The scope of the parent directory
+     * @return The new scope, the parent scope if the file has no rules
+     */
+    static ScopePtr load(const QString &directory, const ScopePtr &parent);
+
+    /**
+     * @brief Check if a path is ignored
+     * @param path The absolute path below the directory of this scope
+     * @param isDirectory True if the path is a directory
+     * @return True if ignored, otherwise false
+     */
+    bool isIgnored(const QString &path, bool isDirectory) const;
+
+private:
+    struct Rule {
+        QRegularExpression expression;
+        bool negated = false;
+        bool directoryOnly = false;
+        bool matchName = false; /**< @brief Pattern has no slash and matches the name at any depth */
+    };
+
+    ScopePtr m_parent;
+    QString m_directory;
+    QVector<Rule> m_rules;
+};
+
+} // namespace Internal
+} // namespace ROSProjectManager
+
+#endif // ROS_PATH_FILTER_H
@@ -0,0 +1,319 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ros_path_store.h"
+
+#include <QSet>
+#include <QVarLengthArray>
+
+namespace ROSProjectManager {
+namespace Internal {
+
+ROSPathStore::ROSPathStore() :
+    m_fileCount(0)
+{
+}
+
+ROSPathStore::ROSPathStore(const QString &root) :
+    m_root(root),
+    m_fileCount(0)
+{
+    // The root is always index 0
+    m_directories.append(Directory());
+}
+
+ROSPathStore ROSPathStore::fromFolderContent(const QString &root, const QHash<QString, ROSUtils::FolderContent> &content)
+{
+    ROSPathStore store(root);
+    store.m_directories.reserve(content.size());
+    store.m_children.reserve(content.size());
+    for (auto it = content.constBegin(); it != content.constEnd(); ++it)
+        store.setContent(it.key(), it.value());
+
+    return store;
+}
+
+QString ROSPathStore::root() const
+{
+    return m_root;
+}
+
+bool ROSPathStore::isEmpty() const
+{
+    return m_directories.isEmpty();
+}
+
+int ROSPathStore::directoryCount() const
+{
+    return static_cast<int>(m_directories.size() - m_freeDirectories.size());
+}
+
+int ROSPathStore::fileCount() const
+{
+    return m_fileCount;
+}
+
+bool ROSPathStore::contains(const QString &directory) const
+{
+    return find(directory) != InvalidIndex;
+}
+
+ROSUtils::FolderContent ROSPathStore::content(const QString &directory) const
+{
+    ROSUtils::FolderContent content;
+    const Index index = find(directory);
+    if (index == InvalidIndex)
+        return content;
+
+    const Directory &entry = m_directories.at(index);
+    content.files.reserve(entry.files.size());
+    for (Index name : entry.files)
+        content.files.append(m_names.at(name));
+
+    content.directories.reserve(entry.children.size());
+    for (Index child : entry.children)
+        content.directories.append(m_names.at(m_directories.at(child).name));
+
+    return content;
+}
+
+bool ROSPathStore::setContent(const QString &directory, const ROSUtils::FolderContent &content, QStringList *removedDirectories)
+{
+    const Index index = findOrCreate(directory);
+    if (index == InvalidIndex)
+        return false;
+
+    QVector<Index> files;
+    files.reserve(content.files.size());
+    for (const QString &file : content.files)
+        files.append(intern(file));
+
+    m_fileCount += static_cast<int>(files.size() - m_directories.at(index).files.size());
+    m_directories[index].files = std::move(files);
+
+    QSet<Index> names;
+    names.reserve(content.directories.size());
+    for (const QString &name : content.directories)
+        names.insert(intern(name));
+
+    // Remove subdirectories that are gone, keep the content of the ones that still exist
+    const QVector<Index> children = m_directories.at(index).children;
+    for (Index child : children)
+    {
+        if (!names.remove(m_directories.at(child).name))
+            remove(child, removedDirectories);
+    }
+
+    for (Index name : std::as_const(names))
+        createChild(index, name);
+
+    return true;
+}
+
+void ROSPathStore::removeDirectory(const QString &directory, QStringList *removedDirectories)
+{
+    const Index index = find(directory);
+    if (index == InvalidIndex)
+        return;
+
+    // The root itself always stays, only its content is removed
+    if (index == 0)
+    {
+        if (removedDirectories)
+            removedDirectories->append(m_root);
+
+        const QVector<Index> children = m_directories.at(0).children;
+        for (Index child : children)
+            remove(child, removedDirectories);
+
+        m_fileCount -= static_cast<int>(m_directories.at(0).files.size());
+        m_directories[0].files.clear();
+        return;
+    }
+
+    remove(index, removedDirectories);
+}
+
+Utils::FilePaths ROSPathStore::directories() const
+{
+    Utils::FilePaths paths;
+    paths.reserve(directoryCount());
+    for (Index i = 0; i < static_cast<Index>(m_directories.size()); ++i)
+    {
+        if (i == 0 || m_directories.at(i).parent != InvalidIndex)
+            paths.append(Utils::FilePath::fromString(path(i)));
+    }
+
+    return paths;
+}
+
+Utils::FilePaths ROSPathStore::files() const
+{
+    Utils::FilePaths paths;
+    paths.reserve(m_fileCount);
+    for (Index i = 0; i < static_cast<Index>(m_directories.size()); ++i)
+    {
+        const Directory &entry = m_directories.at(i);
+        if (entry.files.isEmpty())
+            continue;
+
+        const QString prefix = path(i) + QLatin1Char('/');
+        for (Index name : entry.files)
+            paths.append(Utils::FilePath::fromString(prefix + m_names.at(name)));
+    }
+
+    return paths;
+}
+
+quint64 ROSPathStore::childKey(Index parent, Index name)
+{
+    return (static_cast<quint64>(parent) << 32) | name;
+}
+
+ROSPathStore::Index ROSPathStore::intern(const QString &name)
+{
+    auto it = m_nameIndexes.constFind(name);
+    if (it != m_nameIndexes.constEnd())
+        return it.value();
+
+    const Index index = static_cast<Index>(m_names.size());
+    m_names.append(name);
+    m_nameIndexes.insert(name, index);
+    return index;
+}
+
+ROSPathStore::Index ROSPathStore::find(const QString &directory) const
+{
+    if (m_directories.isEmpty())
+        return InvalidIndex;
+
+    if (directory == m_root)
+        return 0;
+
+    if (directory.size() <= m_root.size() || !directory.startsWith(m_root) || directory.at(m_root.size()) != QLatin1Char('/'))
+        return InvalidIndex;
+
+    Index index = 0;
+    const QStringView relative = QStringView(directory).mid(m_root.size() + 1);
+    for (const QStringView part : relative.tokenize(QLatin1Char('/'), Qt::SkipEmptyParts))
+    {
+        const Index name = m_nameIndexes.value(part.toString(), InvalidIndex);
+        if (name == InvalidIndex)
+            return InvalidIndex;
+
+        index = m_children.value(childKey(index, name), InvalidIndex);
+        if (index == InvalidIndex)
+            return InvalidIndex;
+    }
+
+    return index;
+}
+
+ROSPathStore::Index ROSPathStore::findOrCreate(const QString &directory)
+{
+    if (m_directories.isEmpty())
+        return InvalidIndex;
+
+    if (directory == m_root)
+        return 0;
+
+    if (directory.size() <= m_root.size() || !directory.startsWith(m_root) || directory.at(m_root.size()) != QLatin1Char('/'))
+        return InvalidIndex;
+
+    Index index = 0;
+    const QStringView relative = QStringView(directory).mid(m_root.size() + 1);
+    for (const QStringView part : relative.tokenize(QLatin1Char('/'), Qt::SkipEmptyParts))
+    {
+        const Index name = intern(part.toString());
+        const Index child = m_children.value(childKey(index, name), InvalidIndex);
+        index = (child == InvalidIndex) ? createChild(index, name) : child;
+    }
+
+    return index;
+}
+
+ROSPathStore::Index ROSPathStore::createChild(Index parent, Index name)
+{
+    Index index;
+    if (!m_freeDirectories.isEmpty())
+    {
+        index = m_freeDirectories.takeLast();
+    }
+    else
+    {
+        index = static_cast<Index>(m_directories.size());
+        m_directories.append(Directory());
+    }
+
+    Directory &entry = m_directories[index];
+    entry.parent = parent;
+    entry.name = name;
+
+    m_directories[parent].children.append(index);
+    m_children.insert(childKey(parent, name), index);
+    return index;
+}
+
+void ROSPathStore::remove(Index index, QStringList *removedDirectories)
+{
+    if (removedDirectories)
+        removedDirectories->append(path(index));
+
+    const QVector<Index> children = m_directories.at(index).children;
+    for (Index child : children)
+        remove(child, removedDirectories);
+
+    Directory &entry = m_directories[index];
+    m_children.remove(childKey(entry.parent, entry.name));
+    m_directories[entry.parent].children.removeOne(index);
+    m_fileCount -= static_cast<int>(entry.files.size());
+
+    // The slot is reused by the next directory that is added
+    m_directories[index] = Directory();
+    m_freeDirectories.append(index);
+}
+
+QString ROSPathStore::path(Index index) const
+{
+    if (index == 0)
+        return m_root;
+
+    QVarLengthArray<Index, 32> names;
+    qsizetype size = m_root.size();
+    for (Index i = index; i != 0; i = m_directories.at(i).parent)
+    {
+        names.append(m_directories.at(i).name);
+        size += 1 + m_names.at(m_directories.at(i).name).size();
+    }
+
+    QString result;
+    result.reserve(size);
+    result += m_root;
+    for (auto it = names.crbegin(); it != names.crend(); ++it)
+    {
+        result += QLatin1Char('/');
+        result += m_names.at(*it);
+    }
+
+    return result;
+}
+
+} // namespace Internal
+} // namespace ROSProjectManager
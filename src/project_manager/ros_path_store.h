@@ -0,0 +1,147 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ROS_PATH_STORE_H
+#define ROS_PATH_STORE_H
+
+#include "ros_utils.h"
+
+#include <utils/filepath.h>
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace ROSProjectManager {
+namespace Internal {
+
+/**
+ * @brief Compact storage of the directories and files of a workspace.
+ *
+ * Every file and directory name is interned once. A directory is stored as the index
+ * of its parent plus the index of its name, a file as the index of its name in the
+ * list of its directory. Absolute paths are only built on demand by the accessors.
+ */
+class ROSPathStore
+{
+public:
+    /** @brief Create an empty store without a root */
+    ROSPathStore();
+
+    /**
+     * @brief Create an empty store
+     * @param root The absolute path of the root directory, all stored directories are below it
+     */
+    explicit ROSPathStore(const QString &root);
+
+    /**
+     * @brief Create a store from the result of a directory scan
+     * @param root The absolute path of the root directory
+     * @param content Directory, FolderContent for every scanned directory
+     * @return The store
+     */
+    static ROSPathStore fromFolderContent(const QString &root, const QHash<QString, ROSUtils::FolderContent> &content);
+
+    /** @brief Get the absolute path of the root directory */
+    QString root() const;
+
+    /** @brief Check if the store has no root */
+    bool isEmpty() const;
+
+    /** @brief Get the number of stored directories, including the root */
+    int directoryCount() const;
+
+    /** @brief Get the number of stored files */
+    int fileCount() const;
+
+    /**
+     * @brief Check if a directory is stored
+     * @param directory The absolute directory path
+     * @return True if stored, otherwise false
+     */
+    bool contains(const QString &directory) const;
+
+    /**
+     * @brief Get the content of a directory
+     * @param directory The absolute directory path
+     * @return The file and subdirectory names, empty if the directory is not stored
+     */
+    ROSUtils::FolderContent content(const QString &directory) const;
+
+    /**
+     * @brief Set the content of a directory, the directory and its parents are added if needed.
+     *
+     * Subdirectories that are no longer part of the content are removed with everything below them.
+     *
+     * @param directory The absolute directory path, must be the root or below it
+     * @param content The file and subdirectory names
+     * @param removedDirectories If not nullptr, the absolute paths of removed directories are appended
+     * @return False if the directory is not below the root, otherwise true
+     */
+    bool setContent(const QString &directory, const ROSUtils::FolderContent &content, QStringList *removedDirectories = nullptr);
+
+    /**
+     * @brief Remove a directory and everything below it
+     * @param directory The absolute directory path
+     * @param removedDirectories If not nullptr, the absolute paths of removed directories are appended
+     */
+    void removeDirectory(const QString &directory, QStringList *removedDirectories = nullptr);
+
+    /** @brief Get the absolute paths of all stored directories */
+    Utils::FilePaths directories() const;
+
+    /** @brief Get the absolute paths of all stored files */
+    Utils::FilePaths files() const;
+
+private:
+    typedef quint32 Index;
+    static constexpr Index InvalidIndex = ~Index(0);
+
+    struct Directory
+    {
+        Index parent = InvalidIndex;  /**< @brief Parent directory, InvalidIndex for the root and unused slots */
+        Index name = InvalidIndex;    /**< @brief Interned name, InvalidIndex for unused slots */
+        QVector<Index> files;         /**< @brief Interned file names */
+        QVector<Index> children;      /**< @brief Subdirectory indexes */
+    };
+
+    static quint64 childKey(Index parent, Index name);
+
+    Index intern(const QString &name);
+    Index find(const QString &directory) const;
+    Index findOrCreate(const QString &directory);
+    Index createChild(Index parent, Index name);
+    void remove(Index index, QStringList *removedDirectories);
+    QString path(Index index) const;
+
+    QString m_root;
+    QVector<QString> m_names;
+    QHash<QString, Index> m_nameIndexes;
+    QVector<Directory> m_directories;
+    QVector<Index> m_freeDirectories;
+    QHash<quint64, Index> m_children;   /**< @brief (parent, name) to directory index */
+    int m_fileCount;
+};
+
+} // namespace Internal
+} // namespace ROSProjectManager
+
+#endif // ROS_PATH_STORE_H
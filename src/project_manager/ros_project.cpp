@@ -24,8 +24,15 @@
 #include "ros_catkin_make_step.h"
 #include "ros_project_constants.h"
 #include "ros_utils.h"
+#include "ros_settings_page.h"
+#include "ros_workspace_scan_cache.h"
+#include "ros_package_info_cache.h"
+#include "ros_package_index.h"
+#include "ros_header_path_cache.h"
 
 #include <coreplugin/documentmanager.h>
+#include <coreplugin/editormanager/editormanager.h>
+#include <coreplugin/editormanager/ieditor.h>
 #include <coreplugin/icontext.h>
 #include <coreplugin/icore.h>
 #include <coreplugin/vcsmanager.h>
@@ -43,6 +50,7 @@
 #include <projectexplorer/projectexplorerconstants.h>
 #include <projectexplorer/buildmanager.h>
 #include <projectexplorer/projectexplorer.h>
+#include <projectexplorer/projecttree.h>
 #include <qtsupport/baseqtversion.h>
 #include <projectexplorer/customexecutablerunconfiguration.h>
 #include <qtsupport/qtcppkitinfo.h>
@@ -52,6 +60,7 @@
 #include <utils/qtcassert.h>
 #include <utils/algorithm.h>
 
+#include <QCryptographicHash>
 #include <QDir>
 #include <QtWidgets>
 #include <QProcessEnvironment>
@@ -67,55 +76,14 @@ using namespace ProjectExplorer;
 namespace ROSProjectManager {
 namespace Internal {
 
-static FolderNode *folderNode(const FolderNode *folder, const Utils::FilePath &directory)
+static ProjectExplorer::FileType fileType(const QString &fileName)
 {
-    return static_cast<FolderNode *>(folder->findChildFolderNode([&](FolderNode *fn) {
-        return fn && fn->filePath() == directory;
-    }));
-}
+    // The suffix is taken from the name alone, the file itself is never touched
+    const qsizetype dot = fileName.lastIndexOf(QLatin1Char('.'));
+    if (dot >= 0 && Constants::HEADER_FILE_EXTENSIONS.contains(QStringView(fileName).mid(dot + 1)))
+        return ProjectExplorer::FileType::Header;
 
-static FolderNode *recursiveFindOrCreateFolderNode(FolderNode *folder,
-                                                   const Utils::FilePath &directory,
-                                                   const Utils::FilePath &overrideBaseDir,
-                                                   const FolderNode::FolderNodeFactory &factory)
-{
-    Utils::FilePath path = overrideBaseDir.isEmpty() ? folder->filePath() : overrideBaseDir;
-
-    Utils::FilePath directoryWithoutPrefix;
-    bool isRelative = false;
-
-    if (path.isEmpty() || path.toFileInfo().isRoot()) {
-        directoryWithoutPrefix = directory;
-        isRelative = false;
-    } else {
-        if (directory.isChildOf(path) || directory == path) {
-            isRelative = true;
-            directoryWithoutPrefix = directory.relativeChildPath(path);
-        } else {
-            isRelative = false;
-            path.clear();
-            directoryWithoutPrefix = directory;
-        }
-    }
-    QStringList parts = directoryWithoutPrefix.toString().split('/', Qt::SkipEmptyParts);
-    if (!Utils::HostOsInfo::isWindowsHost() && !isRelative && parts.count() > 0)
-        parts[0].prepend('/');
-
-    ProjectExplorer::FolderNode *parent = folder;
-    for (const QString &part : parts) {
-        path = path.pathAppended(part);
-        // Find folder in subFolders
-        FolderNode *next = folderNode(parent, path);
-        if (!next) {
-            // No FolderNode yet, so create it
-            auto tmp = factory(path);
-            tmp->setDisplayName(part);
-            next = tmp.get();
-            parent->addNode(std::move(tmp));
-        }
-        parent = next;
-    }
-    return parent;
+    return ProjectExplorer::FileType::Source;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -125,11 +93,18 @@ static FolderNode *recursiveFindOrCreateFolderNode(FolderNode *folder,
 ////////////////////////////////////////////////////////////////////////////////////
 const int UPDATE_INTERVAL = 300;
 
+// Above this number of changed entries the tree is rebuilt by a full scan instead of patched
+const int MAX_INCREMENTAL_CHANGES = 1000;
+
 ROSProject::ROSProject(const Utils::FilePath &fileName) :
     ProjectExplorer::Project(Constants::ROS_MIME_TYPE, fileName),
+    m_packageInfoCache(std::make_shared<ROSPackageInfoCache>()),
     m_cppCodeModelUpdater(new CppEditor::CppProjectUpdater),
+    m_scanCache(std::make_shared<ROSWorkspaceScanCache>(ROSWorkspaceScanCache::cacheFilePath(fileName))),
     m_project_loaded(false),
     m_asyncUpdateFutureInterface(nullptr),
+    m_scanGeneration(0),
+    m_scanResultsHandled(0),
     m_asyncBuildCodeModelFutureInterface(nullptr)
 {
     setId(Constants::ROS_PROJECT_ID);
@@ -146,12 +121,29 @@ ROSProject::ROSProject(const Utils::FilePath &fileName) :
     connect(ProjectExplorer::BuildManager::instance(), SIGNAL(buildQueueFinished(bool)),
             this, SLOT(buildQueueFinished(bool)));
 
+    connect(&m_futureWatcher, &QFutureWatcher<FutureWatcherResults>::resultsReadyAt, this, &ROSProject::scanResultsReady);
     connect(&m_futureWatcher, &QFutureWatcher<FutureWatcherResults>::finished, this, &ROSProject::updateProjectTree);
 
     connect(&m_futureBuildCodeModelWatcher, &QFutureWatcher<CppToolsFutureResults>::finished, this, &ROSProject::updateCppCodeModel);
 
-    connect(&m_watcher, SIGNAL(directoryChanged(QString)),
-            this, SLOT(fileSystemChanged(QString)));
+    // Emitted by the code model worker, the connection queues it to the GUI thread
+    connect(m_packageInfoCache.get(), &ROSPackageInfoCache::packagesInvalidated, this, &ROSProject::packagesInvalidated);
+
+    connect(&m_watcher, &ROSFileSystemWatcher::directoriesChanged, this, &ROSProject::fileSystemChanged);
+    connect(&m_watcher, &ROSFileSystemWatcher::rescanRequired, this, [this]() {
+        m_asyncUpdateTimer.setInterval(UPDATE_INTERVAL);
+        m_asyncUpdateTimer.start();
+    });
+
+    // Packages are loaded on demand when they or their files are selected or opened
+    connect(ProjectExplorer::ProjectTree::instance(), &ProjectExplorer::ProjectTree::currentNodeChanged, this, [this](Node *node) {
+        if (node)
+            loadPackageContent(node->filePath());
+    });
+    connect(Core::EditorManager::instance(), &Core::EditorManager::currentEditorChanged, this, [this](Core::IEditor *editor) {
+        if (editor)
+            loadPackageContent(editor->document()->filePath());
+    });
 }
 
 ROSProject::~ROSProject()
@@ -166,6 +158,9 @@ ROSProject::~ROSProject()
     m_cppCodeModelUpdater = nullptr;
 
     if (m_asyncUpdateFutureInterface) {
+        if (m_scanResultsHandled == 0 && m_asyncUpdateFutureInterface->resultCount() > 0)
+            delete m_asyncUpdateFutureInterface->resultReference(0).node;
+
         m_asyncUpdateFutureInterface->reportCanceled();
         m_asyncUpdateFutureInterface->reportFinished();
         delete m_asyncUpdateFutureInterface;
@@ -223,6 +218,21 @@ ROSUtils::PackageBuildInfoMap ROSProject::getPackageBuildInfo() const
     return m_wsPackageBuildInfo;
 }
 
+ROSPackageDependencyGraph ROSProject::getPackageDependencyGraph() const
+{
+    return m_wsPackageGraph;
+}
+
+QString ROSProject::packageAt(const Utils::FilePath &directory) const
+{
+    const QString package = m_wsPackageGraph.packageForFile(directory);
+    const auto it = m_wsPackageInfo.constFind(package);
+    if (it == m_wsPackageInfo.constEnd() || it.value().path != directory)
+        return QString();
+
+    return package;
+}
+
 void ROSProject::refresh()
 {
     // Parse project file and then update project
@@ -234,97 +244,260 @@ void ROSProject::refresh()
 
 void ROSProject::updateProjectTree()
 {
-  if (m_futureWatcher.isFinished())
+  // Only the latest scan is watched, it may still have been canceled from the progress indicator
+  if (!m_futureWatcher.isFinished() || !m_asyncUpdateFutureInterface)
+    return;
+
+  // Results reported right before the scan finished may not have been delivered yet
+  scanResultsReady(m_scanResultsHandled, m_futureWatcher.future().resultCount());
+
+  const bool canceled = m_futureWatcher.isCanceled();
+  m_asyncUpdateFutureInterface->reportFinished();
+  delete m_asyncUpdateFutureInterface;
+  m_asyncUpdateFutureInterface = nullptr;
+
+  if (canceled)
+    return;
+
+  if (m_scanResultsHandled == 0)
+  {
+    Core::MessageManager::writeSilently("[ROS Warning] Update Project Tree Failed, Results returned null pointer.");
+    return;
+  }
+
+  if (!m_project_loaded)
+  {
+    m_project_loaded = true;
+    asyncUpdateCppCodeModel(true);
+  }
+}
+
+void ROSProject::scanResultsReady(int /*begin*/, int end)
+{
+  // Results are taken in order, none is skipped even if notifications were merged.
+  // The packages of merged notifications are attached together, the tree is only set once.
+  QHash<QString, QHash<QString, ROSUtils::FolderContent>> packages;
+  for (int index = m_scanResultsHandled; index < end; ++index)
   {
-    std::unique_ptr<ProjectExplorer::ProjectNode> pn(m_futureWatcher.result().node);
-    if (!pn)
+    FutureWatcherResults results = m_futureWatcher.resultAt(index);
+    m_scanResultsHandled = index + 1;
+
+    if (m_futureWatcher.isCanceled() || results.generation != m_scanGeneration)
     {
-        Core::MessageManager::writeSilently("[ROS Warning] Update Project Tree Failed, Results returned null pointer.");
-        return;
+      delete results.node;
+      continue;
     }
-    setRootProjectNode(std::move(pn));
 
-    if (!m_asyncUpdateFutureInterface)
+    for (const QString &message : std::as_const(results.messages))
+      Core::MessageManager::writeSilently(message);
+
+    if (results.node)
     {
-        Core::MessageManager::writeSilently("[ROS Warning] Update Project Tree Failed, Async Futur Interface was null.");
-        // TODO Need to print warning
-        return;
+      attachPackageContent(packages);
+      packages.clear();
+      setProjectTree(results);
+    }
+    else if (!results.package.isEmpty())
+    {
+      packages.insert(results.package, std::move(results.packageContent));
     }
+  }
 
-    m_workspaceContent = std::move(m_futureWatcher.result().workspaceContent);
-    m_workspaceFiles = std::move(m_futureWatcher.result().files);
-    m_workspaceDirectories = std::move(m_futureWatcher.result().directories);
+  attachPackageContent(packages);
+}
 
-    m_asyncUpdateFutureInterface->reportFinished();
-    delete m_asyncUpdateFutureInterface;
-    m_asyncUpdateFutureInterface = nullptr;
-    m_watcher.addPaths(m_workspaceDirectories);
+void ROSProject::setProjectTree(FutureWatcherResults &results)
+{
+  setRootProjectNode(std::unique_ptr<ProjectExplorer::ProjectNode>(results.node));
+  results.node = nullptr;
 
-    connect(&m_watcher, SIGNAL(directoryChanged(QString)),
-            this, SLOT(fileSystemChanged(QString)));
+  m_workspaceContent = std::move(results.workspaceContent);
 
-    if (!m_project_loaded)
-    {
-      m_project_loaded = true;
-      asyncUpdateCppCodeModel(true);
-    }
+  const QStringList packages = results.packages;
+  m_lazyPackages = QSet<QString>(packages.begin(), packages.end());
+  m_loadingPackages.clear();
+
+  // Only watches for directories that appeared or disappeared since the last scan are changed
+  QStringList watchedDirectories;
+  for (const Utils::FilePath &directory : m_workspaceContent.directories())
+    watchedDirectories.append(directory.toString());
+
+  m_watcher.setDirectories(watchedDirectories);
+
+  // The scan delivers the packages itself, the package of the current editor first
+  if (results.streaming)
+    return;
+
+  // Packages that were loaded before the rescan and the package of the current editor stay loaded
+  for (const QString &package : packages)
+  {
+    if (m_loadedPackages.contains(package))
+      loadPackageContent(Utils::FilePath::fromString(package));
   }
+
+  if (Core::IDocument *document = Core::EditorManager::currentDocument())
+    loadPackageContent(document->filePath());
 }
 
-void ROSProject::buildProjectTree(const Utils::FilePath projectFilePath, const Utils::FilePath& sourcePath, QFutureInterface<FutureWatcherResults> &fi)
+void ROSProject::buildProjectTree(const Utils::FilePath projectFilePath, const ROSUtils::BuildSystem buildSystem, const Utils::FilePath distribution, const ROSPathFilter filter, const bool lazy, const bool stream, const Utils::FilePath priorityPath, const quint64 generation, std::shared_ptr<ROSWorkspaceScanCache> scanCache, QFutureInterface<FutureWatcherResults> &fi)
 {
     fi.reportStarted();
 
     FutureWatcherResults results;
+    results.generation = generation;
+    bool streaming = stream && !lazy;
 
-    results.workspaceContent = ROSUtils::getFolderContentRecursive(sourcePath, results.files, results.directories);
+    // A superseded scan may still be winding down, only one scan uses the index at a time
+    QMutexLocker scanLocker(&scanCache->scanMutex());
+    if (fi.isCanceled())
+    {
+        fi.reportFinished();
+        return;
+    }
 
-    ROSProjectNode* project_node(new ROSProjectNode(projectFilePath.parentDir()));
-    std::unique_ptr<FileNode> root_node(new FileNode(projectFilePath, ProjectExplorer::FileType::Project));
-    project_node->addNode(std::move(root_node));
+    const Utils::FilePath sourcePath = ROSUtils::getWorkspaceInfo(projectFilePath.parentDir(), buildSystem, distribution).sourcePath;
 
-    const ProjectExplorer::FolderNode::FolderNodeFactory &factory = [](const Utils::FilePath &fn) { return std::make_unique<ROSFolderNode>(fn); };
+    // The index is only read from disk for the first scan, afterwards it is kept in memory
+    if (!scanCache->isLoaded())
+        scanCache->load();
 
-    std::vector<std::unique_ptr<ProjectExplorer::FileNode>> childNodes;
-    QHash<QString, ROSUtils::FolderContent>::const_iterator item = results.workspaceContent.constBegin();
-    int cnt = 0;
-    double max = results.workspaceContent.size();
-    while(item != results.workspaceContent.constEnd())
+    scanCache->beginScan(sourcePath.toString());
+
+    // Package contents are not part of the tree if they are loaded on demand or published one by one
+    const auto isCanceled = [&fi]() { return fi.isCanceled(); };
+    const bool stopAtPackages = lazy || streaming;
+    QStringList files, directories;
+    const QHash<QString, ROSUtils::FolderContent> workspaceContent = ROSUtils::getFolderContentRecursive(sourcePath, files, directories, filter, scanCache.get(), stopAtPackages ? &results.packages : nullptr,
+                                                                                                        QString(), isCanceled);
+    files.clear();
+    directories.clear();
+
+    // A canceled scan is incomplete, it must not replace the index
+    if (fi.isCanceled())
     {
-      if (item.value().files.empty()) {
-        // This is required so empty directories show up in project tree
-        Utils::FilePath empty_directory = Utils::FilePath::fromString(item.key());
-        recursiveFindOrCreateFolderNode(project_node, empty_directory, Utils::FilePath(), factory);
-      }
-      else {
-        // Add all files in the directory node
-        for (const QString& file : item.value().files)
+        fi.reportFinished();
+        return;
+    }
+
+    // The package of the current editor is published first, the others in a stable order
+    streaming = streaming && !results.packages.isEmpty();
+    results.streaming = streaming;
+    results.packages.sort();
+    const QString priority = priorityPath.toString();
+    for (int i = 0; i < results.packages.size(); ++i)
+    {
+        if (priority.startsWith(results.packages.at(i) + QLatin1Char('/')))
         {
-          QFileInfo fileInfo(QDir(item.key()), file);
+            results.packages.move(i, 0);
+            break;
+        }
+    }
 
-          ProjectExplorer::FileType fileType = ProjectExplorer::FileType::Source;
+    if (!streaming)
+    {
+        // Packages loaded on demand are not descended into, their listings stay for the next load
+        if (lazy)
+            scanCache->keepSubtrees(results.packages);
 
-          if (Constants::HEADER_FILE_EXTENSIONS.contains(fileInfo.suffix()))
-            fileType = ProjectExplorer::FileType::Header;
+        if (!scanCache->save())
+            results.messages.append(QObject::tr("[ROS Warning] Failed to save workspace scan index: %1.").arg(ROSWorkspaceScanCache::cacheFilePath(projectFilePath).toString()));
 
-          std::unique_ptr<ProjectExplorer::FileNode> fileNode(new ProjectExplorer::FileNode(Utils::FilePath::fromString(fileInfo.absoluteFilePath()), fileType));
-          childNodes.emplace_back(std::move(fileNode));
-        }
+        scanLocker.unlock();
+    }
+
+    ROSProjectNode* project_node(new ROSProjectNode(projectFilePath.parentDir()));
+    std::unique_ptr<FileNode> root_node(new FileNode(projectFilePath, ProjectExplorer::FileType::Project));
+    project_node->addFileNode(project_node, std::move(root_node));
+
+    QHash<QString, ROSUtils::FolderContent>::const_iterator item = workspaceContent.constBegin();
+    int cnt = 0;
+    double max = workspaceContent.size();
+    while(item != workspaceContent.constEnd())
+    {
+      // Every directory gets a node, so empty directories show up in project tree
+      const Utils::FilePath directory = Utils::FilePath::fromString(item.key());
+      ProjectExplorer::FolderNode *folder = project_node->findOrCreateFolderNode(directory);
+
+      // Add all files in the directory node
+      for (const QString& file : item.value().files)
+      {
+        std::unique_ptr<ProjectExplorer::FileNode> fileNode(new ProjectExplorer::FileNode(directory.pathAppended(file), fileType(file)));
+        project_node->addFileNode(folder, std::move(fileNode));
+      }
+
+      if (fi.isCanceled())
+      {
+        delete project_node;
+        fi.reportFinished();
+        return;
       }
 
       cnt += 1;
-      fi.setProgressValue(static_cast<int>(100.0 * static_cast<double>(cnt) / max));
+      if (!streaming)
+        fi.setProgressValue(static_cast<int>(100.0 * static_cast<double>(cnt) / max));
+
       ++item;
     }
 
-    project_node->addNestedNodes(std::move(childNodes), Utils::FilePath(), factory);
+    // The scan result is only kept in compact form
+    results.workspaceContent = ROSPathStore::fromFolderContent(sourcePath.toString(), workspaceContent);
     results.node = project_node;
 
+    // The result is dropped if the scan was canceled in the meantime
+    ProjectExplorer::ProjectNode *node = results.node;
+    const QStringList packages = results.packages;
+    if (!fi.reportResult(std::move(results)))
+    {
+      delete node;
+      fi.reportFinished();
+      return;
+    }
+
+    if (!streaming)
+    {
+      fi.setProgressValue(fi.progressMaximum());
+      fi.reportFinished();
+      return;
+    }
+
+    // Publish the packages one by one, each result is attached to the tree as soon as it arrives
+    for (int i = 0; i < packages.size(); ++i)
+    {
+      FutureWatcherResults package;
+      package.generation = generation;
+      package.package = packages.at(i);
+      package.packageContent = ROSUtils::getFolderContentRecursive(Utils::FilePath::fromString(package.package), files, directories, filter, scanCache.get(), nullptr,
+                                                                   sourcePath.toString(), isCanceled);
+      files.clear();
+      directories.clear();
+
+      if (fi.isCanceled() || !fi.reportResult(std::move(package)))
+      {
+        fi.reportFinished();
+        return;
+      }
+
+      fi.setProgressValue(static_cast<int>(100.0 * static_cast<double>(i + 1) / static_cast<double>(packages.size())));
+    }
+
+    if (!scanCache->save())
+    {
+        FutureWatcherResults messages;
+        messages.generation = generation;
+        messages.messages.append(QObject::tr("[ROS Warning] Failed to save workspace scan index: %1.").arg(ROSWorkspaceScanCache::cacheFilePath(projectFilePath).toString()));
+        fi.reportResult(std::move(messages));
+    }
+
     fi.setProgressValue(fi.progressMaximum());
-    fi.reportResult(std::move(results));
     fi.reportFinished();
 }
 
+void ROSProject::packagesInvalidated(const QStringList &/*changed*/, const QStringList &/*removed*/)
+{
+  // A package may have been renamed, the package lists of the run steps are read again
+  ROSPackageIndex::clear();
+}
+
 void ROSProject::updateEnvironment()
 {
   if (ROSBuildConfiguration *bc = rosBuildConfiguration())
@@ -334,36 +507,231 @@ void ROSProject::updateEnvironment()
   }
 }
 
-void ROSProject::fileSystemChanged(const QString &path)
+void ROSProject::fileSystemChanged(const QStringList &paths)
 {
-  const ROSUtils::FolderContent& pre_content = m_workspaceContent[path];
+  QHash<QString, ROSUtils::FolderContent> changed;
+  for (const QString &path : paths)
+  {
+    // Directories that are no longer part of the tree are handled through their parent
+    if (!m_workspaceContent.contains(path) || m_lazyPackages.contains(path))
+      continue;
 
-  QStringList folderNameFilters, fileNameFilters;
-  ROSUtils::getDefaultFolderContentFilters(folderNameFilters, fileNameFilters);
-  const ROSUtils::FolderContent& cur_content = ROSUtils::getFolderContent(path, folderNameFilters, fileNameFilters);
+    // A new ignore marker removes the directory from its parent
+    QString directory = path;
+    if (path != m_workspaceContent.root() && ROSPathFilter::containsIgnoreMarker(path))
+    {
+      directory = QFileInfo(path).path();
+      if (!m_workspaceContent.contains(directory))
+        continue;
+    }
 
-  QSet<QString> pre_content_files(pre_content.files.begin(), pre_content.files.end());
-  QSet<QString> pre_content_dirs(pre_content.directories.begin(), pre_content.directories.end());
+    const ROSUtils::FolderContent pre_content = m_workspaceContent.content(directory);
+    ROSUtils::FolderContent cur_content = ROSUtils::getFolderContent(directory, m_pathFilter, m_workspaceContent.root());
 
-  QSet<QString> cur_content_files(cur_content.files.begin(), cur_content.files.end());
-  QSet<QString> cur_content_dirs(cur_content.directories.begin(), cur_content.directories.end());
+    QSet<QString> pre_content_files(pre_content.files.begin(), pre_content.files.end());
+    QSet<QString> pre_content_dirs(pre_content.directories.begin(), pre_content.directories.end());
 
-  // Content that has been added
-  QSet<QString> files_added = cur_content_files - pre_content_files;
-  QSet<QString> dirs_added = cur_content_dirs - pre_content_dirs;
+    QSet<QString> cur_content_files(cur_content.files.begin(), cur_content.files.end());
+    QSet<QString> cur_content_dirs(cur_content.directories.begin(), cur_content.directories.end());
 
-  // Content that has been removed
-  QSet<QString> files_removed = pre_content_files - cur_content_files;
-  QSet<QString> dirs_removed = pre_content_dirs - cur_content_dirs;
+    // This is to check if untracked dirs or files were added or removed. If so do not update.
+    if (pre_content_files != cur_content_files || pre_content_dirs != cur_content_dirs)
+      changed.insert(directory, std::move(cur_content));
+  }
 
-  // This is to check if untracked dirs or files were added. If so do not start timer.
-  if (files_added.empty() && dirs_added.empty() && files_removed.empty() && dirs_removed.empty())
+  if (changed.isEmpty() || applyFileSystemChanges(changed))
     return;
 
   m_asyncUpdateTimer.setInterval(UPDATE_INTERVAL);
   m_asyncUpdateTimer.start();
 }
 
+bool ROSProject::applyFileSystemChanges(const QHash<QString, ROSUtils::FolderContent> &changed)
+{
+  const ROSProjectNode *current = static_cast<const ROSProjectNode *>(rootProjectNode());
+  if (!current || m_asyncUpdateFutureInterface)
+    return false;
+
+  // Read the subtrees of new directories first, so nothing is modified if there is too much to patch
+  int budget = MAX_INCREMENTAL_CHANGES;
+  QStringList pending;
+  for (auto it = changed.constBegin(); it != changed.constEnd(); ++it)
+  {
+    if (it.key() == m_workspaceContent.root() && !QFileInfo(it.key()).isDir())
+      return false;
+
+    const ROSUtils::FolderContent pre_content = m_workspaceContent.content(it.key());
+    const QSet<QString> pre_content_files(pre_content.files.begin(), pre_content.files.end());
+    const QSet<QString> pre_content_dirs(pre_content.directories.begin(), pre_content.directories.end());
+    const QSet<QString> cur_content_files(it.value().files.begin(), it.value().files.end());
+    const QSet<QString> cur_content_dirs(it.value().directories.begin(), it.value().directories.end());
+
+    // A new or removed .gitignore changes the filtering of the whole subtree
+    if (pre_content_files.contains(QLatin1String(".gitignore")) != cur_content_files.contains(QLatin1String(".gitignore")))
+      return false;
+
+    budget -= static_cast<int>((cur_content_files - pre_content_files).size() + (pre_content_files - cur_content_files).size());
+    for (const QString &directory : cur_content_dirs - pre_content_dirs)
+      pending.append(it.key() + QLatin1Char('/') + directory);
+  }
+
+  QHash<QString, ROSUtils::FolderContent> added;
+  while (!pending.isEmpty())
+  {
+    const QString directory = pending.takeLast();
+    ROSUtils::FolderContent content = ROSUtils::getFolderContent(directory, m_pathFilter, m_workspaceContent.root());
+    budget -= 1 + static_cast<int>(content.files.size());
+    if (budget < 0)
+      return false;
+
+    for (const QString &subDirectory : std::as_const(content.directories))
+      pending.append(directory + QLatin1Char('/') + subDirectory);
+
+    added.insert(directory, std::move(content));
+  }
+
+  // The project indexes its files when the root node is set, so a copy of the tree is patched and set
+  std::unique_ptr<ROSProjectNode> root = current->clone();
+
+  // Parents are patched before their children, children of removed directories are skipped
+  QStringList directories = changed.keys();
+  directories.sort();
+
+  QStringList removedDirectories;
+  for (const QString &directory : std::as_const(directories))
+  {
+    if (!m_workspaceContent.contains(directory) || !QFileInfo(directory).isDir())
+      continue;
+
+    const ROSUtils::FolderContent pre_content = m_workspaceContent.content(directory);
+    const ROSUtils::FolderContent cur_content = changed.value(directory);
+    const QSet<QString> pre_content_files(pre_content.files.begin(), pre_content.files.end());
+    const QSet<QString> pre_content_dirs(pre_content.directories.begin(), pre_content.directories.end());
+    const QSet<QString> cur_content_files(cur_content.files.begin(), cur_content.files.end());
+    const QSet<QString> cur_content_dirs(cur_content.directories.begin(), cur_content.directories.end());
+
+    FolderNode *folder = root->findOrCreateFolderNode(Utils::FilePath::fromString(directory));
+
+    for (const QString &file : pre_content_files - cur_content_files)
+    {
+      if (FileNode *node = root->findFileNode(Utils::FilePath::fromString(directory + QLatin1Char('/') + file)))
+        root->removeFileNode(node);
+    }
+
+    for (const QString &file : cur_content_files - pre_content_files)
+      root->addFileNode(folder, std::make_unique<FileNode>(Utils::FilePath::fromString(directory + QLatin1Char('/') + file), fileType(file)));
+
+    for (const QString &subDirectory : pre_content_dirs - cur_content_dirs)
+    {
+      const QString path = directory + QLatin1Char('/') + subDirectory;
+      if (FolderNode *node = root->findFolderNode(Utils::FilePath::fromString(path)))
+        root->removeFolderNode(node);
+    }
+
+    // Removes the subtrees of removed subdirectories as well
+    m_workspaceContent.setContent(directory, cur_content, &removedDirectories);
+  }
+
+  for (auto it = added.constBegin(); it != added.constEnd(); ++it)
+  {
+    FolderNode *folder = root->findOrCreateFolderNode(Utils::FilePath::fromString(it.key()));
+    for (const QString &file : it.value().files)
+      root->addFileNode(folder, std::make_unique<FileNode>(Utils::FilePath::fromString(it.key() + QLatin1Char('/') + file), fileType(file)));
+
+    m_workspaceContent.setContent(it.key(), it.value());
+  }
+
+  for (const QString &directory : std::as_const(removedDirectories))
+    m_lazyPackages.remove(directory);
+
+  m_watcher.removeDirectories(removedDirectories);
+  m_watcher.addDirectories(added.keys());
+
+  setRootProjectNode(std::move(root));
+  return true;
+}
+
+void ROSProject::loadPackageContent(const Utils::FilePath &path)
+{
+  if (m_lazyPackages.isEmpty())
+    return;
+
+  // Find the package containing the path
+  QString package = path.toString();
+  while (!m_lazyPackages.contains(package))
+  {
+    const int index = static_cast<int>(package.lastIndexOf(QLatin1Char('/')));
+    if (index <= 0)
+      return;
+
+    package.truncate(index);
+  }
+
+  if (m_loadingPackages.contains(package))
+    return;
+
+  m_loadingPackages.insert(package);
+
+  auto watcher = new QFutureWatcher<QHash<QString, ROSUtils::FolderContent>>(this);
+  connect(watcher, &QFutureWatcher<QHash<QString, ROSUtils::FolderContent>>::finished, this, [this, watcher, package]() {
+    // Loads started before the tree was rebuilt are dropped
+    if (!watcher->isCanceled() && m_loadingPackages.contains(package))
+      attachPackageContent({{package, watcher->result()}});
+
+    watcher->deleteLater();
+  });
+
+  watcher->setFuture(Utils::asyncRun(ProjectExplorer::ProjectExplorerPlugin::sharedThreadPool(),
+    [package, filter = m_pathFilter, root = m_workspaceContent.root(), scanCache = m_scanCache]() {
+      // The package is listed from the index like the rest of the workspace and added to it
+      QMutexLocker scanLocker(&scanCache->scanMutex());
+      QStringList files, directories;
+      const QHash<QString, ROSUtils::FolderContent> content = ROSUtils::getFolderContentRecursive(Utils::FilePath::fromString(package), files, directories, filter, scanCache.get(), nullptr, root);
+
+      // A failure is reported by the scans, which save to the same file
+      scanCache->save();
+      return content;
+    }));
+}
+
+void ROSProject::attachPackageContent(const QHash<QString, QHash<QString, ROSUtils::FolderContent>> &packages)
+{
+  // A package may have been removed, or attached by the scan or an on demand load, while it was read
+  const ROSProjectNode *current = static_cast<const ROSProjectNode *>(rootProjectNode());
+  QHash<QString, QHash<QString, ROSUtils::FolderContent>> attach;
+  for (auto it = packages.constBegin(); it != packages.constEnd(); ++it)
+  {
+    m_loadingPackages.remove(it.key());
+    if (current && m_lazyPackages.remove(it.key()))
+      attach.insert(it.key(), it.value());
+  }
+
+  if (attach.isEmpty())
+    return;
+
+  // The files only become known to the project through setRootProjectNode(), see applyFileSystemChanges()
+  std::unique_ptr<ROSProjectNode> root = current->clone();
+  QStringList directories;
+  for (auto package = attach.constBegin(); package != attach.constEnd(); ++package)
+  {
+    for (auto it = package.value().constBegin(); it != package.value().constEnd(); ++it)
+    {
+      FolderNode *folder = root->findOrCreateFolderNode(Utils::FilePath::fromString(it.key()));
+      for (const QString &file : it.value().files)
+        root->addFileNode(folder, std::make_unique<FileNode>(Utils::FilePath::fromString(it.key() + QLatin1Char('/') + file), fileType(file)));
+
+      m_workspaceContent.setContent(it.key(), it.value());
+      directories.append(it.key());
+    }
+
+    m_loadedPackages.insert(package.key());
+  }
+
+  m_watcher.addDirectories(directories);
+
+  setRootProjectNode(std::move(root));
+}
+
 void ROSProject::asyncUpdate()
 {
   ROSBuildConfiguration *bc = rosBuildConfiguration();
@@ -372,17 +740,21 @@ void ROSProject::asyncUpdate()
 
   bc->buildSystem()->requestParse();
 
-  m_futureWatcher.waitForFinished();
-
-  Q_ASSERT(!m_asyncUpdateFutureInterface);
+  // A running scan is superseded, it stops at its next directory and its result is discarded
+  if (m_asyncUpdateFutureInterface)
+  {
+    m_asyncUpdateFutureInterface->cancel();
 
-  m_asyncUpdateFutureInterface = new QFutureInterface<FutureWatcherResults>();
+    // A project tree reported before the cancel is never delivered, it is always the first result
+    if (m_scanResultsHandled == 0 && m_asyncUpdateFutureInterface->resultCount() > 0)
+      delete m_asyncUpdateFutureInterface->resultReference(0).node;
 
-  disconnect(&m_watcher, SIGNAL(directoryChanged(QString)),
-             this, SLOT(fileSystemChanged(QString)));
+    delete m_asyncUpdateFutureInterface;
+  }
 
-  if (!m_watcher.directories().empty())
-    m_watcher.removePaths(m_watcher.directories());
+  const quint64 generation = ++m_scanGeneration;
+  m_scanResultsHandled = 0;
+  m_asyncUpdateFutureInterface = new QFutureInterface<FutureWatcherResults>();
 
   m_asyncUpdateFutureInterface->setProgressRange(0, 100);
   Core::ProgressManager::addTask(m_asyncUpdateFutureInterface->future(),
@@ -391,24 +763,48 @@ void ROSProject::asyncUpdate()
 
   m_futureWatcher.setFuture(m_asyncUpdateFutureInterface->future());
 
+  // The filter is compiled once per scan from the current settings
+  m_pathFilter = ROSPathFilter::fromSettings();
+  const bool lazy = ROSProjectPlugin::instance()->settings()->lazy_project_tree;
+
+  // Until the project was loaded once the tree is published package by package, starting
+  // with the package of the current editor. Rescans replace the complete tree at once.
+  const bool stream = !m_project_loaded;
+  Utils::FilePath priorityPath;
+  if (Core::IDocument *document = Core::EditorManager::currentDocument())
+    priorityPath = document->filePath();
+
+  // The scan only works on copies, so it may outlive this project
   Utils::asyncRun(ProjectExplorer::ProjectExplorerPlugin::sharedThreadPool(), QThread::LowestPriority,
-    [this, bc]() {
-      Utils::FilePath sourcePath = ROSUtils::getWorkspaceInfo(projectDirectory(), bc->rosBuildSystem(), distribution()).sourcePath;
-      ROSProject::buildProjectTree(projectFilePath(), sourcePath, *m_asyncUpdateFutureInterface);
+    [fi = *m_asyncUpdateFutureInterface, projectFile = projectFilePath(), buildSystem = bc->rosBuildSystem(),
+     distribution = distribution(), filter = m_pathFilter, lazy, stream, priorityPath, generation, scanCache = m_scanCache]() mutable {
+      ROSProject::buildProjectTree(projectFile, buildSystem, distribution, filter, lazy, stream, priorityPath, generation, scanCache, fi);
     });
 }
 
-void ROSProject::asyncUpdateCppCodeModel(bool success)
+void ROSProject::asyncUpdateCppCodeModel(bool success, const QSet<QString> &reloadPackages)
 {
-    if (success && !m_workspaceFiles.empty() && (rosBuildConfiguration() != nullptr))
+    // Lazily loaded packages have no files listed yet, so only the scanned source directory is required
+    if (success && m_workspaceContent.contains(m_workspaceContent.root()) && (rosBuildConfiguration() != nullptr))
     {
-        bool async = false;
+        const Kit *k = nullptr;
+
+        if (Target *target = activeTarget())
+            k = target->kit();
+        else
+            k = KitManager::defaultKit();
+
+        QTC_ASSERT(k, return);
 
         m_cppCodeModelUpdater->cancel();
 
-        m_futureBuildCodeModelWatcher.waitForFinished();
+        // A running update is superseded, it stops at its next package and its result is discarded
+        if (m_asyncBuildCodeModelFutureInterface)
+        {
+            m_asyncBuildCodeModelFutureInterface->cancel();
+            delete m_asyncBuildCodeModelFutureInterface;
+        }
 
-        Q_ASSERT(!m_asyncBuildCodeModelFutureInterface);
         m_asyncBuildCodeModelFutureInterface = new QFutureInterface<CppToolsFutureResults>();
 
         m_asyncBuildCodeModelFutureInterface->setProgressRange(0, 100);
@@ -416,55 +812,84 @@ void ROSProject::asyncUpdateCppCodeModel(bool success)
                                        tr("Parsing Build Files for Project \"%1\"").arg(displayName()),
                                        Constants::ROS_RELOADING_BUILD_INFO);
 
-        ROSUtils::WorkspaceInfo workspaceInfo = ROSUtils::getWorkspaceInfo(projectDirectory(), rosBuildConfiguration()->rosBuildSystem(), distribution());
-        Utils::Environment current_environment = rosBuildConfiguration()->environment();
-
-        const Kit *k = nullptr;
+        m_futureBuildCodeModelWatcher.setFuture(m_asyncBuildCodeModelFutureInterface->future());
 
-        if (Target *target = activeTarget())
-            k = target->kit();
-        else
-            k = KitManager::defaultKit();
+        // Everything the update needs from the project and the kit is copied here, on the GUI thread
+        CppCodeModelSnapshot snapshot = cppCodeModelSnapshot(k, reloadPackages);
 
-        QTC_ASSERT(k, return);
+        // The update only works on the snapshot, so it may outlive this project
+        Utils::asyncRun(ProjectExplorer::ProjectExplorerPlugin::sharedThreadPool(), QThread::LowestPriority,
+          [fi = *m_asyncBuildCodeModelFutureInterface, snapshot = std::move(snapshot)]() mutable {
+            ROSProject::buildCppCodeModel(snapshot, fi);
+          });
+    }
+}
 
-        m_futureBuildCodeModelWatcher.setFuture(m_asyncBuildCodeModelFutureInterface->future());
+ROSProject::CppCodeModelSnapshot ROSProject::cppCodeModelSnapshot(const Kit *k, const QSet<QString> &reloadPackages) const
+{
+    CppCodeModelSnapshot snapshot;
+    snapshot.workspaceInfo = ROSUtils::getWorkspaceInfo(projectDirectory(), rosBuildConfiguration()->rosBuildSystem(), distribution());
+    snapshot.projectFilePath = projectFilePath();
+    snapshot.scanCache = m_scanCache;
+    snapshot.environment = rosBuildConfiguration()->environment();
+    snapshot.kitId = k->id();
+    snapshot.sysRoot = SysRootKitAspect::sysRoot(k);
 
-        // TODO: Figure out why running this async causes segfaults
-        if (async)
-        {
-          Utils::asyncRun(ProjectExplorer::ProjectExplorerPlugin::sharedThreadPool(), QThread::LowestPriority, [this, workspaceInfo, k, current_environment]() { ROSProject::buildCppCodeModel(workspaceInfo, projectFilePath(), m_workspaceFiles, k, current_environment, m_wsPackageInfo, m_wsPackageBuildInfo, *m_asyncBuildCodeModelFutureInterface); });
-        }
+    if (QtSupport::QtVersion *qtVersion = QtSupport::QtKitAspect::qtVersion(k)) {
+        if (qtVersion->qtVersion() < QVersionNumber(5,0,0))
+            snapshot.qtVersion = Utils::QtMajorVersion::Qt4;
+        else if (qtVersion->qtVersion() < QVersionNumber(6,0,0))
+            snapshot.qtVersion = Utils::QtMajorVersion::Qt5;
         else
-        {
-          ROSProject::buildCppCodeModel(workspaceInfo, projectFilePath(), m_workspaceFiles, k, current_environment, m_wsPackageInfo, m_wsPackageBuildInfo, *m_asyncBuildCodeModelFutureInterface);
-        }
+            snapshot.qtVersion = Utils::QtMajorVersion::Qt6;
+    }
+
+    // The runner holds copies of the tool chain settings and may be called from any thread
+    if (const ToolChain *cxxToolChain = ToolChainKitAspect::cxxToolChain(k))
+    {
+        snapshot.headerPathsRunner = cxxToolChain->createBuiltInHeaderPathsRunner(snapshot.environment);
+        snapshot.headerPathCache = ROSHeaderPathCache::forKit(k->id());
+        snapshot.toolChainKey = ROSHeaderPathCache::toolChainKey(cxxToolChain, snapshot.environment);
     }
+
+    snapshot.packageInfoCache = m_packageInfoCache;
+    snapshot.wsPackageBuildInfo = m_wsPackageBuildInfo;
+    snapshot.reloadPackages = reloadPackages;
+    snapshot.packageParts = m_wsPackageParts;
+    snapshot.packagePartsKey = m_wsPackagePartsKey;
+    return snapshot;
 }
 
-void ROSProject::buildCppCodeModel(const ROSUtils::WorkspaceInfo workspaceInfo,
-                                   const Utils::FilePath projectFilePath,
-                                   const QStringList /*workspaceFiles*/,
-                                   const Kit *k,
-                                   const Utils::Environment &env,
-                                   const ROSUtils::PackageInfoMap wsPackageInfo,
-                                   const ROSUtils::PackageBuildInfoMap wsPackageBuildInfo,
+void ROSProject::buildCppCodeModel(const CppCodeModelSnapshot &snapshot,
                                    QFutureInterface<CppToolsFutureResults> &fi)
 {
+    const ROSUtils::WorkspaceInfo &workspaceInfo = snapshot.workspaceInfo;
+    const ROSUtils::PackageBuildInfoMap &wsPackageBuildInfo = snapshot.wsPackageBuildInfo;
+    const QSet<QString> &reloadPackages = snapshot.reloadPackages;
+    const Utils::FilePath &sysRoot = snapshot.sysRoot;
+    const Utils::QtMajorVersion activeQtVersion = snapshot.qtVersion;
+
     CppToolsFutureResults results;
-    results.wsPackageInfo = ROSUtils::getWorkspacePackageInfo(workspaceInfo, &wsPackageInfo);
-    results.wsPackageBuildInfo = ROSUtils::getWorkspacePackageBuildInfo(workspaceInfo, results.wsPackageInfo, &wsPackageBuildInfo);
+    // Package discovery reuses the unfiltered directory listings of the workspace scan
+    results.wsPackageInfo = ROSUtils::getWorkspacePackageInfo(workspaceInfo, snapshot.packageInfoCache.get(), snapshot.scanCache.get(), snapshot.environment,
+                                                              [&fi]() { return fi.isCanceled(); });
+    if (fi.isCanceled())
+    {
+        fi.reportFinished();
+        return;
+    }
 
-    const Utils::FilePath sysRoot = SysRootKitAspect::sysRoot(k);
+    results.wsPackageGraph = ROSPackageDependencyGraph(results.wsPackageInfo);
 
-    Utils::QtMajorVersion activeQtVersion = Utils::QtMajorVersion::None;
-    if (QtSupport::QtVersion *qtVersion = QtSupport::QtKitAspect::qtVersion(k)) {
-        if (qtVersion->qtVersion() < QVersionNumber(5,0,0))
-            activeQtVersion = Utils::QtMajorVersion::Qt4;
-        else if (qtVersion->qtVersion() < QVersionNumber(6,0,0))
-            activeQtVersion = Utils::QtMajorVersion::Qt5;
-        else
-            activeQtVersion = Utils::QtMajorVersion::Qt6;
+    // Reading the build directories is the first half of the progress, creating the project parts the second
+    results.wsPackageBuildInfo = ROSUtils::getWorkspacePackageBuildInfo(workspaceInfo, results.wsPackageInfo, &wsPackageBuildInfo, reloadPackages, [&fi](int finished, int total) {
+        fi.setProgressValue(static_cast<int>(50.0 * static_cast<double>(finished) / static_cast<double>(total)));
+    });
+
+    if (fi.isCanceled())
+    {
+        fi.reportFinished();
+        return;
     }
 
     // Get all of the workspace includes directories
@@ -481,14 +906,44 @@ void ROSProject::buildCppCodeModel(const ROSUtils::WorkspaceInfo workspaceInfo,
 
     ProjectExplorer::RawProjectParts rpps;
 
-    const ToolChain *cxxToolChain = ToolChainKitAspect::cxxToolChain(k);
-
-    if (cxxToolChain)
+    // The parts of a package also depend on the kit, the environment and the include directories of all packages
+    QCryptographicHash partsKey(QCryptographicHash::Sha1);
+    partsKey.addData(snapshot.kitId.toString().toUtf8());
+    partsKey.addData(sysRoot.toString().toUtf8());
+    partsKey.addData(QByteArray::number(static_cast<int>(activeQtVersion)));
+    partsKey.addData(snapshot.environment.toStringList().join(QLatin1Char('\n')).toUtf8());
+    partsKey.addData(workspace_includes.join(QLatin1Char('\n')).toUtf8());
+    results.packagePartsKey = partsKey.result();
+
+    const QHash<QString, ProjectExplorer::RawProjectParts> &packageParts = snapshot.packageParts;
+    const QString projectFile = snapshot.projectFilePath.toString();
+    if (snapshot.headerPathsRunner)
     {
         int cnt = 0;
         double max = results.wsPackageBuildInfo.size();
         for (const ROSUtils::PackageBuildInfo& buildInfo : qAsConst(results.wsPackageBuildInfo))
         {
+            if (fi.isCanceled())
+            {
+                fi.reportFinished();
+                return;
+            }
+
+            // Packages whose build information did not change keep their parts
+            const auto previousBuildInfo = wsPackageBuildInfo.constFind(buildInfo.parent.name);
+            const auto previousParts = packageParts.constFind(buildInfo.parent.name);
+            if (results.packagePartsKey == snapshot.packagePartsKey && !reloadPackages.contains(buildInfo.parent.name)
+                && previousBuildInfo != wsPackageBuildInfo.constEnd() && previousParts != packageParts.constEnd()
+                && !buildInfo.fingerprint.isEmpty() && previousBuildInfo.value().fingerprint == buildInfo.fingerprint)
+            {
+                results.packageParts.insert(buildInfo.parent.name, previousParts.value());
+                rpps.append(previousParts.value());
+                cnt += 1;
+                fi.setProgressValue(50 + static_cast<int>(50.0 * static_cast<double>(cnt) / max));
+                continue;
+            }
+
+            ProjectExplorer::RawProjectParts packageRpps;
             ProjectExplorer::HeaderPaths packageHeaderPaths = workspace_header_paths;
             QStringList package_includes = workspace_includes; // This should be the same as packageHeaderPaths and is used to check for duplicates
 
@@ -504,16 +959,15 @@ void ROSProject::buildCppCodeModel(const ROSUtils::WorkspaceInfo workspaceInfo,
                             return result;
                         }).join('\n');
 
-                rpp.setProjectFileLocation(projectFilePath.toString());
-                rpp.setBuildSystemTarget(buildInfo.parent.name + '|' + targetInfo->name + '|' + projectFilePath.toString());
+                rpp.setProjectFileLocation(projectFile);
+                rpp.setBuildSystemTarget(buildInfo.parent.name + '|' + targetInfo->name + '|' + projectFile);
                 rpp.setDisplayName(buildInfo.parent.name + '|' + targetInfo->name);
                 rpp.setQtVersion(activeQtVersion);
                 rpp.setMacros(ProjectExplorer::Macro::toMacros(defineArg.toUtf8()));
 
                 QSet<QString> toolChainIncludes;
-                const HeaderPaths header_paths = \
-                        cxxToolChain->createBuiltInHeaderPathsRunner(env)\
-                        (targetInfo->flags, sysRoot, QString());
+                // Most targets share a configuration, the compiler only runs for the first of them
+                const HeaderPaths header_paths = snapshot.headerPathCache->headerPaths(snapshot.toolChainKey, targetInfo->flags, sysRoot, snapshot.headerPathsRunner);
                 for (const HeaderPath &hp : header_paths) {
                     toolChainIncludes.insert(hp.path);
                 }
@@ -525,14 +979,22 @@ void ROSProject::buildCppCodeModel(const ROSUtils::WorkspaceInfo workspaceInfo,
                     }
                 }
 
-                rpp.setFlagsForCxx({cxxToolChain, targetInfo->flags, sysRoot});
+                // The tool chain classifies the flags on the GUI thread, see updateCppCodeModel()
+                ProjectExplorer::RawProjectPartFlags cxxFlags;
+                cxxFlags.commandLineFlags = targetInfo->flags;
+                rpp.setFlagsForCxx(cxxFlags);
                 rpp.setFiles(targetInfo->source_files);
                 rpp.setHeaderPaths(packageHeaderPaths);
-                rpps.append(rpp);
+                packageRpps.append(rpp);
             }
+            results.packageParts.insert(buildInfo.parent.name, packageRpps);
+            rpps.append(packageRpps);
             cnt += 1;
-            fi.setProgressValue(static_cast<int>(100.0 * static_cast<double>(cnt) / max));
+            fi.setProgressValue(50 + static_cast<int>(50.0 * static_cast<double>(cnt) / max));
         }
+
+        if (!snapshot.headerPathCache->save())
+            results.messages.append(QObject::tr("[ROS Warning] Failed to save built-in header path cache: %1.").arg(snapshot.headerPathCache->cacheFile().toString()));
     }
 
     results.parts = std::move(rpps);
@@ -543,23 +1005,53 @@ void ROSProject::buildCppCodeModel(const ROSUtils::WorkspaceInfo workspaceInfo,
 
 void ROSProject::updateCppCodeModel()
 {
-  if (m_futureBuildCodeModelWatcher.isFinished())
+  // The watcher only follows the latest update, superseded updates never get here
+  const bool canceled = m_futureBuildCodeModelWatcher.isCanceled() || m_futureBuildCodeModelWatcher.future().resultCount() == 0;
+
+  delete m_asyncBuildCodeModelFutureInterface;
+  m_asyncBuildCodeModelFutureInterface = nullptr;
+
+  if (canceled)
+    return;
+
+  CppToolsFutureResults results = m_futureBuildCodeModelWatcher.result();
+  m_wsPackageInfo = std::move(results.wsPackageInfo);
+  m_wsPackageBuildInfo = std::move(results.wsPackageBuildInfo);
+  m_wsPackageGraph = std::move(results.wsPackageGraph);
+  m_wsPackageParts = std::move(results.packageParts);
+  m_wsPackagePartsKey = results.packagePartsKey;
+
+  for (const QString &message : std::as_const(results.messages))
+    Core::MessageManager::writeSilently(message);
+
+  // Cycles break the build order of catkin and colcon, they are only reported when they change
+  const QList<QStringList> cycles = m_wsPackageGraph.cycles();
+  if (cycles != m_wsPackageCycles)
   {
-    m_wsPackageInfo = std::move(m_futureBuildCodeModelWatcher.result().wsPackageInfo);
-    m_wsPackageBuildInfo = std::move(m_futureBuildCodeModelWatcher.result().wsPackageBuildInfo);
+    for (const QStringList &cycle : cycles)
+      Core::MessageManager::writeSilently(tr("[ROS Warning] Dependency cycle between packages: %1.").arg(cycle.join(QLatin1String(", "))));
 
-    QtSupport::CppKitInfo kitInfo(this->activeTarget()->kit());
-    QTC_ASSERT(kitInfo.isValid(), return);
+    m_wsPackageCycles = cycles;
+  }
 
-    m_cppCodeModelUpdater->update({this, kitInfo, rosBuildConfiguration()->environment(), m_futureBuildCodeModelWatcher.result().parts});
+  Target *target = activeTarget();
+  QTC_ASSERT(target, return);
 
-    m_asyncBuildCodeModelFutureInterface->reportFinished();
-    delete m_asyncBuildCodeModelFutureInterface;
-    m_asyncBuildCodeModelFutureInterface = nullptr;
+  QtSupport::CppKitInfo kitInfo(target->kit());
+  QTC_ASSERT(kitInfo.isValid(), return);
 
-    updateEnvironment();
+  // The tool chain is not thread safe, so the flags are only classified here
+  ProjectExplorer::RawProjectParts parts = std::move(results.parts);
+  if (const ToolChain *cxxToolChain = ToolChainKitAspect::cxxToolChain(target->kit()))
+  {
+    const Utils::FilePath sysRoot = SysRootKitAspect::sysRoot(target->kit());
+    for (ProjectExplorer::RawProjectPart &rpp : parts)
+      rpp.setFlagsForCxx({cxxToolChain, rpp.flagsForCxx.commandLineFlags, sysRoot});
   }
 
+  m_cppCodeModelUpdater->update({this, kitInfo, rosBuildConfiguration()->environment(), parts});
+
+  updateEnvironment();
 }
 
 Project::RestoreResult ROSProject::fromMap(const Utils::Store &map, QString *errorMessage)
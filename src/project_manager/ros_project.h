@@ -24,6 +24,10 @@
 #include "ros_project_plugin.h"
 #include "ros_utils.h"
 #include "ros_build_system.h"
+#include "ros_path_filter.h"
+#include "ros_file_system_watcher.h"
+#include "ros_path_store.h"
+#include "ros_package_graph.h"
 
 #include <projectexplorer/project.h>
 #include <projectexplorer/projectnodes.h>
@@ -37,7 +41,6 @@
 #include <QFutureWatcher>
 #include <QFutureInterface>
 #include <QTimer>
-#include <QFileSystemWatcher>
 
 namespace CppEditor {
     class CppProjectUpdater;
@@ -48,11 +51,15 @@ namespace Internal {
 
 class ROSProjectFile;
 class ROSBuildConfiguration;
+class ROSWorkspaceScanCache;
+class ROSPackageInfoCache;
+class ROSHeaderPathCache;
 
 class ROSProject : public ProjectExplorer::Project
 {
     Q_OBJECT
     friend class ROSProjectPlugin;
+    friend class ROSProjectTest;
 
 public:
     ROSProject(const Utils::FilePath &filename);
@@ -66,45 +73,79 @@ public:
 
     ROSUtils::PackageInfoMap getPackageInfo() const;
     ROSUtils::PackageBuildInfoMap getPackageBuildInfo() const;
+    ROSPackageDependencyGraph getPackageDependencyGraph() const;
+
+    /**
+     * @brief Get the package a directory is the root of
+     * @param directory The directory
+     * @return The package name, empty if the directory is not a package directory
+     */
+    QString packageAt(const Utils::FilePath &directory) const;
 
 public slots:
     void buildQueueFinished(bool success);
-    void fileSystemChanged(const QString &path);
+    void fileSystemChanged(const QStringList &paths);
 
 private slots:
     void updateProjectTree();
+    void scanResultsReady(int begin, int end);
     void updateCppCodeModel();
+    void packagesInvalidated(const QStringList &changed, const QStringList &removed);
 
 protected:
     Project::RestoreResult fromMap(const Utils::Store &map, QString *errorMessage) override;
 
 private:
     void asyncUpdate();
+    bool applyFileSystemChanges(const QHash<QString, ROSUtils::FolderContent> &changed);
+    void loadPackageContent(const Utils::FilePath &path);
+    void attachPackageContent(const QHash<QString, QHash<QString, ROSUtils::FolderContent>> &packages);
     bool saveProjectFile();
-    void asyncUpdateCppCodeModel(bool success);
+    void asyncUpdateCppCodeModel(bool success, const QSet<QString> &reloadPackages = QSet<QString>());
     void updateEnvironment();
 
     ROSUtils::ROSProjectFileContent m_projectFileContent;
     ROSUtils::PackageInfoMap        m_wsPackageInfo;
     ROSUtils::PackageBuildInfoMap   m_wsPackageBuildInfo;
+    ROSPackageDependencyGraph       m_wsPackageGraph;
+    QList<QStringList>              m_wsPackageCycles; /**< @brief The cycles reported last */
+    QHash<QString, ProjectExplorer::RawProjectParts> m_wsPackageParts; /**< @brief Project parts of each package */
+    QByteArray                      m_wsPackagePartsKey;
+    std::shared_ptr<ROSPackageInfoCache> m_packageInfoCache;
 
     CppEditor::CppProjectUpdater *m_cppCodeModelUpdater;
 
     // Watching Directories to keep Project Tree updated
     QTimer m_asyncUpdateTimer;
-    QFileSystemWatcher m_watcher;
-    QHash<QString, ROSUtils::FolderContent> m_workspaceContent;
-    QStringList m_workspaceFiles;
-    QStringList m_workspaceDirectories;
+    ROSFileSystemWatcher m_watcher;
+    ROSPathStore m_workspaceContent;
+    ROSPathFilter m_pathFilter;
+    std::shared_ptr<ROSWorkspaceScanCache> m_scanCache;
+
+    // Packages whose content is loaded on demand
+    QSet<QString> m_lazyPackages;
+    QSet<QString> m_loadingPackages;
+    QSet<QString> m_loadedPackages;
     bool m_project_loaded;
 
 
+    /**
+     * @brief A result of a project scan.
+     *
+     * The first result holds the project tree. If it is streaming, the tree stops at the
+     * package directories and the content of each package follows as a separate result,
+     * followed by a result that only holds the messages of the scan.
+     */
     struct FutureWatcherResults
     {
-      ProjectExplorer::ProjectNode* node;
-      QHash<QString, ROSUtils::FolderContent> workspaceContent;
-      QStringList files;
-      QStringList directories;
+      ProjectExplorer::ProjectNode* node = nullptr; /**< @brief The project tree, nullptr for a package result */
+      quint64 generation = 0;
+      ROSPathStore workspaceContent;
+      QStringList packages;   /**< @brief Packages whose content is not part of the project tree */
+      bool streaming = false; /**< @brief The content of the packages follows as package results */
+      QString package;
+      QHash<QString, ROSUtils::FolderContent> packageContent;
+      QStringList messages;   /**< @brief Written to the general messages on the GUI thread */
     };
 
     struct CppToolsFutureResults
@@ -112,25 +153,68 @@ private:
       ProjectExplorer::RawProjectParts parts;
       ROSUtils::PackageInfoMap wsPackageInfo;
       ROSUtils::PackageBuildInfoMap wsPackageBuildInfo;
+      ROSPackageDependencyGraph wsPackageGraph;
+      QHash<QString, ProjectExplorer::RawProjectParts> packageParts;
+      QByteArray packagePartsKey; /**< @brief Hash of the kit, environment and workspace includes the parts depend on */
+      QStringList messages;       /**< @brief Written to the general messages on the GUI thread */
     };
 
+    /**
+     * @brief The inputs of a code model update.
+     *
+     * Copied from the project and the kit on the GUI thread, the update runs on a worker
+     * thread and never touches the project, the kit or the tool chain.
+     */
+    struct CppCodeModelSnapshot
+    {
+      ROSUtils::WorkspaceInfo workspaceInfo;
+      Utils::FilePath projectFilePath;
+      std::shared_ptr<ROSWorkspaceScanCache> scanCache; /**< @brief Unfiltered listings used for package discovery, shared with the project */
+      Utils::Environment environment;
+      Utils::Id kitId;
+      Utils::FilePath sysRoot;
+      Utils::QtMajorVersion qtVersion = Utils::QtMajorVersion::None;
+      ProjectExplorer::ToolChain::BuiltInHeaderPathsRunner headerPathsRunner; /**< @brief Empty if the kit has no C++ tool chain */
+      std::shared_ptr<ROSHeaderPathCache> headerPathCache; /**< @brief Thread safe, shared by all projects using the kit */
+      QByteArray toolChainKey;
+      std::shared_ptr<ROSPackageInfoCache> packageInfoCache; /**< @brief Thread safe, shared with the project */
+      ROSUtils::PackageBuildInfoMap wsPackageBuildInfo;
+      QSet<QString> reloadPackages;
+      QHash<QString, ProjectExplorer::RawProjectParts> packageParts;
+      QByteArray packagePartsKey;
+    };
+
+    /**
+     * @brief Copy the inputs of a code model update
+     * @note Must be called from the GUI thread.
+     * @param k The kit the code model is built for
+     * @param reloadPackages Packages whose build information is read again
+     * @return The snapshot, buildCppCodeModel() only works on it
+     */
+    CppCodeModelSnapshot cppCodeModelSnapshot(const ProjectExplorer::Kit *k, const QSet<QString> &reloadPackages) const;
+
+    void setProjectTree(FutureWatcherResults &results);
+
     QFutureInterface<FutureWatcherResults> *m_asyncUpdateFutureInterface;
+    quint64 m_scanGeneration; /**< @brief Incremented for every scan, results of older scans are discarded */
+    int m_scanResultsHandled; /**< @brief Number of results of the running scan already taken */
     QFutureWatcher<FutureWatcherResults> m_futureWatcher;
     // Parse Code Blocks Files and build Code Model
     QFutureInterface<CppToolsFutureResults> *m_asyncBuildCodeModelFutureInterface;
     QFutureWatcher<CppToolsFutureResults> m_futureBuildCodeModelWatcher;
 
     static void buildProjectTree(const Utils::FilePath projectFilePath,
-                                 const Utils::FilePath& sourcePath,
+                                 const ROSUtils::BuildSystem buildSystem,
+                                 const Utils::FilePath distribution,
+                                 const ROSPathFilter filter,
+                                 const bool lazy,
+                                 const bool stream,
+                                 const Utils::FilePath priorityPath,
+                                 const quint64 generation,
+                                 std::shared_ptr<ROSWorkspaceScanCache> scanCache,
                                  QFutureInterface<FutureWatcherResults> &fi);
 
-    static void buildCppCodeModel(const ROSUtils::WorkspaceInfo workspaceInfo,
-                                  const Utils::FilePath projectFilePath,
-                                  const QStringList workspaceFiles,
-                                  const ProjectExplorer::Kit *k,
-                                  const Utils::Environment &env,
-                                  const ROSUtils::PackageInfoMap wsPackageInfo,
-                                  const ROSUtils::PackageBuildInfoMap  wsPackageBuildInfo,
+    static void buildCppCodeModel(const CppCodeModelSnapshot &snapshot,
                                   QFutureInterface<CppToolsFutureResults> &fi);
 
 };
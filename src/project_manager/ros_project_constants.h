@@ -41,6 +41,7 @@ const char ROS_INSTALL_DIRECTORY[] = "/opt/ros";
 
 // Context menu actions
 const char ROS_RELOAD_BUILD_INFO[] = "ROSProjectManager.reloadProjectBuildInfo";
+const char ROS_RELOAD_PACKAGE_BUILD_INFO[] = "ROSProjectManager.reloadPackageBuildInfo";
 const char ROS_REMOVE_DIR[] = "ROSProjectManager.removeDirectory";
 const char ROS_RENAME_FILE[] = "ROSProjectManager.renameFile";
 
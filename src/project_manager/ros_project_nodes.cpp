@@ -37,21 +37,96 @@ ROSProjectNode::ROSProjectNode(const Utils::FilePath &projectFilePath) : Project
     setDisplayName(projectFilePath.toFileInfo().completeBaseName());
 }
 
-FileNode *ROSProjectNode::findFileNode(FolderNode *folder_node, const Utils::FilePath &filePaths)
+FolderNode *ROSProjectNode::findOrCreateFolderNode(const Utils::FilePath &directory)
 {
-  FileNode* file_node = folder_node->fileNode(filePaths);
-  if (file_node)
-      return file_node;
-
-  folder_node->findChildFolderNode([&](FolderNode *folder_node) {
-    file_node = findFileNode(folder_node, filePaths);
-    return bool(file_node);
-  });
-
-  if (file_node)
-    return file_node;
-  else
-    return nullptr;
+    if (directory == filePath())
+        return this;
+
+    if (FolderNode *folder = m_folderNodes.value(directory))
+        return folder;
+
+    // Directories outside of the project directory are added below it by absolute path
+    const Utils::FilePath parentDirectory = directory.parentDir();
+    FolderNode *parent = nullptr;
+    QString displayName = directory.fileName();
+    if (!directory.isChildOf(filePath()) && (parentDirectory.isEmpty() || parentDirectory.toFileInfo().isRoot()))
+    {
+        parent = this;
+        displayName = directory.toString();
+    }
+    else
+    {
+        parent = findOrCreateFolderNode(parentDirectory);
+    }
+
+    auto node = std::make_unique<ROSFolderNode>(directory);
+    node->setDisplayName(displayName);
+
+    FolderNode *folder = node.get();
+    parent->addNode(std::move(node));
+    m_folderNodes.insert(directory, folder);
+    return folder;
+}
+
+FolderNode *ROSProjectNode::findFolderNode(const Utils::FilePath &directory) const
+{
+    return m_folderNodes.value(directory);
+}
+
+FileNode *ROSProjectNode::findFileNode(const Utils::FilePath &filePath) const
+{
+    return m_fileNodes.value(filePath);
+}
+
+void ROSProjectNode::addFileNode(FolderNode *folder, std::unique_ptr<FileNode> &&node)
+{
+    m_fileNodes.insert(node->filePath(), node.get());
+    folder->addNode(std::move(node));
+}
+
+void ROSProjectNode::removeFileNode(FileNode *node)
+{
+    m_fileNodes.remove(node->filePath());
+    node->parentFolderNode()->takeNode(node);
+}
+
+void ROSProjectNode::removeFolderNode(FolderNode *node)
+{
+    node->forEachNode([this](FileNode *fn) { m_fileNodes.remove(fn->filePath()); },
+                      [this](FolderNode *fn) { m_folderNodes.remove(fn->filePath()); });
+
+    m_folderNodes.remove(node->filePath());
+    node->parentFolderNode()->takeNode(node);
+}
+
+std::unique_ptr<ROSProjectNode> ROSProjectNode::clone() const
+{
+    auto node = std::make_unique<ROSProjectNode>(filePath());
+    node->setDisplayName(displayName());
+    node->cloneNodes(this, node.get());
+    return node;
+}
+
+void ROSProjectNode::cloneNodes(const FolderNode *source, FolderNode *target)
+{
+    for (const std::unique_ptr<Node> &child : source->nodes())
+    {
+        if (const FileNode *file = child->asFileNode())
+        {
+            addFileNode(target, std::make_unique<FileNode>(file->filePath(), file->fileType()));
+        }
+        else if (const FolderNode *folder = child->asFolderNode())
+        {
+            const auto *rosFolder = dynamic_cast<const ROSFolderNode *>(folder);
+            auto node = std::make_unique<ROSFolderNode>(folder->filePath(), rosFolder ? rosFolder->repository() : nullptr);
+            node->setDisplayName(folder->FolderNode::displayName());
+
+            FolderNode *copy = node.get();
+            target->addNode(std::move(node));
+            m_folderNodes.insert(copy->filePath(), copy);
+            cloneNodes(folder, copy);
+        }
+    }
 }
 
 bool ROSProjectNode::showInSimpleTree() const
@@ -72,6 +147,10 @@ ROSFolderNode::ROSFolderNode(const Utils::FilePath &folderPath) : FolderNode(fol
     }
 }
 
+ROSFolderNode::ROSFolderNode(const Utils::FilePath &folderPath, Core::IVersionControl *repository) : FolderNode(folderPath), m_repository(repository)
+{
+}
+
 QString ROSFolderNode::displayName() const
 {
     if (m_repository)
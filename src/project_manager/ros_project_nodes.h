@@ -43,8 +43,62 @@ public:
 
     bool showInSimpleTree() const override;
 
+    /**
+     * @brief Find the folder node of a directory, creating it and any missing parent folder nodes
+     * @param directory The directory
+     * @return The folder node, this project node if directory is the project directory
+     */
+    ProjectExplorer::FolderNode *findOrCreateFolderNode(const Utils::FilePath &directory);
+
+    /**
+     * @brief Find the folder node of a directory
+     * @param directory The directory
+     * @return The folder node, nullptr if it does not exist
+     */
+    ProjectExplorer::FolderNode *findFolderNode(const Utils::FilePath &directory) const;
+
+    /**
+     * @brief Find the file node of a file
+     * @param filePath The file
+     * @return The file node, nullptr if it does not exist
+     */
+    ProjectExplorer::FileNode *findFileNode(const Utils::FilePath &filePath) const;
+
+    /**
+     * @brief Add a file node to a folder node of this project
+     * @param folder The folder node
+     * @param node The file node
+     */
+    void addFileNode(ProjectExplorer::FolderNode *folder, std::unique_ptr<ProjectExplorer::FileNode> &&node);
+
+    /**
+     * @brief Remove and delete a file node
+     * @param node The file node
+     */
+    void removeFileNode(ProjectExplorer::FileNode *node);
+
+    /**
+     * @brief Remove and delete a folder node and everything below it
+     * @param node The folder node
+     */
+    void removeFolderNode(ProjectExplorer::FolderNode *node);
+
+    /**
+     * @brief Copy this project node and everything below it
+     *
+     * The project only indexes its nodes when a root node is set, so changes are made to a
+     * copy which then replaces the root node.
+     *
+     * @return The copy
+     */
+    std::unique_ptr<ROSProjectNode> clone() const;
+
 private:
-    static ProjectExplorer::FileNode *findFileNode(FolderNode *folder_node, const Utils::FilePath &filePaths);
+    void cloneNodes(const ProjectExplorer::FolderNode *source, ProjectExplorer::FolderNode *target);
+
+    // Every folder and file node below this node by path, so lookups do not walk the tree
+    QHash<Utils::FilePath, ProjectExplorer::FolderNode *> m_folderNodes;
+    QHash<Utils::FilePath, ProjectExplorer::FileNode *> m_fileNodes;
 };
 typedef std::unique_ptr<ROSProjectNode> ROSProjectNodeUPtr;
 
@@ -53,8 +107,18 @@ class ROSFolderNode: public ProjectExplorer::FolderNode
 public:
     explicit ROSFolderNode(const Utils::FilePath &folderPath);
 
+    /**
+     * @brief Constructor, the repository is not looked up again
+     * @param folderPath The directory
+     * @param repository The version control if the directory is the top level of a repository, otherwise nullptr
+     */
+    ROSFolderNode(const Utils::FilePath &folderPath, Core::IVersionControl *repository);
+
     QString displayName() const override;
 
+    /** @brief Get the version control if the directory is the top level of a repository, otherwise nullptr */
+    Core::IVersionControl *repository() const { return m_repository; }
+
 private:
     Core::IVersionControl *m_repository;
 };
@@ -22,6 +22,9 @@
 #ifdef ROSTERMINAL
 #include "ros_terminal_pane.h"
 #endif
+#ifdef WITH_TESTS
+#include "ros_project_test.h"
+#endif
 #include "ros_run_configuration.h"
 #include "ros_rosrun_step.h"
 #include "ros_roslaunch_step.h"
@@ -158,6 +161,10 @@ bool ROSProjectPlugin::initialize(const QStringList &, QString *errorMessage)
 
     ProjectManager::registerProjectType<ROSProject>(Constants::ROS_MIME_TYPE);
 
+#ifdef WITH_TESTS
+    addTest<ROSProjectTest>();
+#endif
+
     IWizardFactory::registerFactoryCreator([]() { return new ROSProjectWizard; });
     IWizardFactory::registerFactoryCreator([]() { return new ROSPackageWizard; });
 
@@ -175,6 +182,21 @@ bool ROSProjectPlugin::initialize(const QStringList &, QString *errorMessage)
     // This will context menu action for deleting and renaming project folders from the ProjectTree.
     ActionContainer *mfolderContextMenu = ActionManager::actionContainer(ProjectExplorer::Constants::M_FOLDERCONTEXT);
 
+    auto reloadPackageBuildInfoAction = new QAction(tr("Reload Package Build Info..."), this);
+    Command *reloadPackageCommand = ActionManager::registerAction(reloadPackageBuildInfoAction,
+                                                                  Constants::ROS_RELOAD_PACKAGE_BUILD_INFO,
+                                                                  Context(Constants::ROS_PROJECT_CONTEXT));
+    reloadPackageCommand->setAttribute(Command::CA_Hide);
+    mfolderContextMenu->addAction(reloadPackageCommand, ProjectExplorer::Constants::G_FOLDER_FILES);
+    connect(reloadPackageBuildInfoAction, &QAction::triggered, this, &ROSProjectPlugin::reloadPackageBuildInfo);
+
+    // Only shown for package directories
+    connect(ProjectTree::instance(), &ProjectTree::currentNodeChanged, this, [reloadPackageBuildInfoAction](Node *node) {
+        ROSProject *rosProject = qobject_cast<ROSProject *>(ProjectTree::currentProject());
+        reloadPackageBuildInfoAction->setEnabled(node && rosProject && node->isFolderNodeType()
+                                                 && !rosProject->packageAt(node->filePath()).isEmpty());
+    });
+
     auto removeProjectDirectoryAction = new QAction(tr("Remove Directory..."), this);
     Command *removeCommand = ActionManager::registerAction(removeProjectDirectoryAction,
                                                            Constants::ROS_REMOVE_DIR,
@@ -259,8 +281,20 @@ void ROSProjectPlugin::createCppCodeStyle()
 
 void ROSProjectPlugin::reloadProjectBuildInfo()
 {
+    // Every package is parsed again, even if its build files look unchanged
     if (ROSProject *rosProject = qobject_cast<ROSProject *>(ProjectTree::currentProject()))
-        rosProject->asyncUpdateCppCodeModel(true);
+        rosProject->asyncUpdateCppCodeModel(true, Utils::toSet(rosProject->getPackageInfo().keys()));
+}
+
+void ROSProjectPlugin::reloadPackageBuildInfo()
+{
+    ProjectExplorer::Node *currentNode = ProjectExplorer::ProjectTree::currentNode();
+    ROSProject *rosProject = qobject_cast<ROSProject *>(ProjectTree::currentProject());
+    QTC_ASSERT(currentNode && rosProject, return);
+
+    const QString package = rosProject->packageAt(currentNode->filePath());
+    if (!package.isEmpty())
+        rosProject->asyncUpdateCppCodeModel(true, {package});
 }
 
 void ROSProjectPlugin::removeProjectDirectory()
@@ -75,6 +75,13 @@ private slots:
      */
     void reloadProjectBuildInfo();
 
+    /**
+     * @brief This will parse the build directory of the selected package and update its build info.
+     *
+     * Other packages are only parsed again if they were configured since they were parsed last.
+     */
+    void reloadPackageBuildInfo();
+
     /**
      * @brief This will remove the selected FolderNode in the project tree.
      */
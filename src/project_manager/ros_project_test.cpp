@@ -0,0 +1,188 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ros_project_test.h"
+#include "ros_project.h"
+#include "ros_utils.h"
+
+#include <projectexplorer/kit.h>
+#include <projectexplorer/kitmanager.h>
+#include <projectexplorer/projectexplorer.h>
+#include <projectexplorer/projectmanager.h>
+
+#include <QFile>
+#include <QThreadPool>
+#include <QXmlStreamWriter>
+#include <QtTest>
+
+using namespace ProjectExplorer;
+
+namespace ROSProjectManager {
+namespace Internal {
+
+static const int PACKAGE_COUNT = 50;
+static const int PROJECT_COUNT = 10;
+static const int UPDATE_COUNT = 5;
+static const int TIMEOUT = 60000;
+
+static bool writeFile(const QString &path, const QByteArray &content)
+{
+    if (!QDir().mkpath(QFileInfo(path).absolutePath()))
+        return false;
+
+    QFile file(path);
+    return file.open(QFile::WriteOnly | QFile::Truncate) && file.write(content) == content.size();
+}
+
+void ROSProjectTest::initTestCase()
+{
+    QVERIFY(m_workspace.isValid());
+
+    // A catkin workspace of packages that each depend on the previous one
+    for (int i = 0; i < PACKAGE_COUNT; ++i)
+    {
+        const QString name = QString("pkg_%1").arg(i);
+        const QString path = m_workspace.path() + QLatin1String("/src/") + name;
+        const QString depend = i > 0 ? QString("  <depend>pkg_%1</depend>\n").arg(i - 1) : QString();
+
+        QVERIFY(writeFile(path + QLatin1String("/package.xml"),
+                          QString("<?xml version=\"1.0\"?>\n"
+                                  "<package format=\"2\">\n"
+                                  "  <name>%1</name>\n"
+                                  "  <version>0.1.0</version>\n"
+                                  "  <description>Stress test package</description>\n"
+                                  "  <maintainer email=\"dev@example.com\">dev</maintainer>\n"
+                                  "  <license>Apache-2.0</license>\n"
+                                  "  <buildtool_depend>catkin</buildtool_depend>\n"
+                                  "%2"
+                                  "</package>\n").arg(name, depend).toUtf8()));
+        QVERIFY(writeFile(path + QLatin1String("/CMakeLists.txt"),
+                          QString("cmake_minimum_required(VERSION 3.10)\n"
+                                  "project(%1)\n"
+                                  "find_package(catkin REQUIRED)\n"
+                                  "catkin_package()\n"
+                                  "add_library(%1 src/%1.cpp)\n").arg(name).toUtf8()));
+        QVERIFY(writeFile(path + QString("/include/%1/%1.h").arg(name), QByteArray("#pragma once\n")));
+        QVERIFY(writeFile(path + QString("/src/%1.cpp").arg(name), QString("#include <%1/%1.h>\n").arg(name).toUtf8()));
+    }
+
+    ROSUtils::ROSProjectFileContent content;
+    content.defaultBuildSystem = ROSUtils::CatkinMake;
+
+    QByteArray projectFile;
+    QXmlStreamWriter writer(&projectFile);
+    ROSUtils::generateQtCreatorWorkspaceFile(writer, content);
+
+    m_projectFile = Utils::FilePath::fromString(m_workspace.path() + QLatin1String("/stress.workspace"));
+    QVERIFY(writeFile(m_projectFile.toString(), projectFile));
+
+    // Opening a project needs a kit, a clean settings directory may not have one
+    if (!KitManager::defaultKit())
+    {
+        m_kit = KitManager::registerKit([](Kit *k) { k->setUnexpandedDisplayName(QLatin1String("ROS Stress Test")); });
+        QVERIFY(m_kit);
+        KitManager::setDefaultKit(m_kit);
+    }
+}
+
+void ROSProjectTest::cleanupTestCase()
+{
+    if (m_kit)
+        KitManager::deregisterKit(m_kit);
+}
+
+ROSProject *ROSProjectTest::openProject()
+{
+    const ProjectExplorerPlugin::OpenProjectResult result = ProjectExplorerPlugin::openProject(m_projectFile);
+    if (!result)
+        return nullptr;
+
+    return qobject_cast<ROSProject *>(result.project());
+}
+
+void ROSProjectTest::supersededUpdatesWhileClosing()
+{
+    for (int round = 0; round < PROJECT_COUNT; ++round)
+    {
+        ROSProject *project = openProject();
+        QVERIFY(project);
+        QTRY_VERIFY_WITH_TIMEOUT(project->m_project_loaded, TIMEOUT);
+
+        // Every update cancels the running one, only the last one may reach updateCppCodeModel()
+        for (int i = 0; i < UPDATE_COUNT; ++i)
+            project->asyncUpdateCppCodeModel(true);
+
+        QVERIFY(project->m_asyncBuildCodeModelFutureInterface);
+
+        if (round % 2 == 0)
+        {
+            QTRY_VERIFY_WITH_TIMEOUT(!project->m_asyncBuildCodeModelFutureInterface, TIMEOUT);
+            QCOMPARE(static_cast<int>(project->getPackageInfo().size()), PACKAGE_COUNT);
+            QCOMPARE(project->getPackageDependencyGraph().dependencies(QLatin1String("pkg_1")), QStringList{QLatin1String("pkg_0")});
+        }
+
+        // Closed while the workers of the superseded updates, or the last one, still run
+        ProjectManager::removeProject(project);
+        QVERIFY(!ProjectManager::projects().contains(project));
+    }
+}
+
+void ROSProjectTest::buildCppCodeModelAfterClose()
+{
+    ROSProject *project = openProject();
+    QVERIFY(project);
+    QTRY_VERIFY_WITH_TIMEOUT(project->m_project_loaded, TIMEOUT);
+
+    Kit *k = project->activeTarget() ? project->activeTarget()->kit() : KitManager::defaultKit();
+    QVERIFY(k);
+    const ROSProject::CppCodeModelSnapshot snapshot = project->cppCodeModelSnapshot(k, QSet<QString>());
+
+    // The snapshot shares the package info cache, the workers outlive the project
+    ProjectManager::removeProject(project);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(4);
+    QList<QFutureInterface<ROSProject::CppToolsFutureResults>> updates;
+    for (int i = 0; i < 8; ++i)
+    {
+        QFutureInterface<ROSProject::CppToolsFutureResults> fi;
+        updates.append(fi);
+        pool.start([snapshot, fi]() mutable { ROSProject::buildCppCodeModel(snapshot, fi); });
+
+        // Every other update is superseded right away
+        if (i % 2)
+            fi.cancel();
+    }
+
+    pool.waitForDone();
+
+    for (int i = 0; i < updates.size(); ++i)
+    {
+        QVERIFY(updates.at(i).isFinished());
+        if (i % 2)
+            continue;
+
+        QCOMPARE(updates.at(i).resultCount(), 1);
+        QCOMPARE(static_cast<int>(updates.at(i).resultReference(0).wsPackageInfo.size()), PACKAGE_COUNT);
+    }
+}
+
+} // namespace Internal
+} // namespace ROSProjectManager
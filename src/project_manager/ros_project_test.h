@@ -0,0 +1,64 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ROS_PROJECT_TEST_H
+#define ROS_PROJECT_TEST_H
+
+#include <utils/filepath.h>
+
+#include <QObject>
+#include <QTemporaryDir>
+
+namespace ProjectExplorer { class Kit; }
+
+namespace ROSProjectManager {
+namespace Internal {
+
+class ROSProject;
+
+/**
+ * @brief Stress test of the code model update of a running IDE, run with -test ROSProjectManager.
+ *
+ * Projects on a generated workspace are opened and closed repeatedly while their code model
+ * updates supersede each other, so the snapshot, the worker and the hand-off to the GUI
+ * thread in updateCppCodeModel() run against the teardown of the project.
+ */
+class ROSProjectTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void supersededUpdatesWhileClosing();
+    void buildCppCodeModelAfterClose();
+
+private:
+    ROSProject *openProject();
+
+    QTemporaryDir m_workspace;
+    Utils::FilePath m_projectFile;
+    ProjectExplorer::Kit *m_kit = nullptr; /**< @brief Registered by the test if there is no default kit */
+};
+
+} // namespace Internal
+} // namespace ROSProjectManager
+
+#endif // ROS_PROJECT_TEST_H
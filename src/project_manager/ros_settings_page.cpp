@@ -42,11 +42,16 @@ static const char DEFAULT_BUILD_SYSTEM_ID[] = "ROSProjectManager.ROSSettingsDefa
 static const char DEFAULT_CODE_STYLE_ID[] = "ROSProjectManager.ROSSettingsDefaultCodeStyle";
 static const char DEFAULT_DISTRIBUTION_PATH_ID[] = "ROSProjectManager.ROSSettingsDefaultDistributionPath";
 static const char CUSTOM_DISTRIBUTION_PATH_ID[] = "ROSProjectManager.ROSSettingsCustomDistributionPath";
+static const char EXCLUDE_PATTERNS_ID[] = "ROSProjectManager.ROSSettingsExcludePatterns";
+static const char LAZY_PROJECT_TREE_ID[] = "ROSProjectManager.ROSSettingsLazyProjectTree";
+static const char CODEBLOCKS_GENERATOR_ID[] = "ROSProjectManager.ROSSettingsCodeBlocksGenerator";
 
 namespace ROSProjectManager {
 namespace Internal {
 
-ROSSettings::ROSSettings()
+ROSSettings::ROSSettings() :
+    lazy_project_tree(false),
+    codeblocks_generator(false)
 {
   m_system_distributions.clear();
   Utils::FilePath ros_path = Utils::FilePath::fromString(Constants::ROS_INSTALL_DIRECTORY);
@@ -76,6 +81,9 @@ void ROSSettings::toSettings(Utils::QtcSettings *s) const
       s->setValue(DEFAULT_DISTRIBUTION_PATH_ID, default_dist_path);
 
     s->setValue(CUSTOM_DISTRIBUTION_PATH_ID, custom_dist_path);
+    s->setValue(EXCLUDE_PATTERNS_ID, exclude_patterns);
+    s->setValue(LAZY_PROJECT_TREE_ID, lazy_project_tree);
+    s->setValue(CODEBLOCKS_GENERATOR_ID, codeblocks_generator);
 
     s->endGroup();
 }
@@ -97,6 +105,9 @@ void ROSSettings::fromSettings(Utils::QtcSettings *s)
       default_dist_path = Constants::ROS_INSTALL_DIRECTORY;
 
     custom_dist_path = s->value(CUSTOM_DISTRIBUTION_PATH_ID, "").toString();
+    exclude_patterns = s->value(EXCLUDE_PATTERNS_ID, QStringList()).toStringList();
+    lazy_project_tree = s->value(LAZY_PROJECT_TREE_ID, false).toBool();
+    codeblocks_generator = s->value(CODEBLOCKS_GENERATOR_ID, false).toBool();
     s->endGroup();
 }
 
@@ -106,7 +117,10 @@ bool ROSSettings::equals(const ROSSettings &rhs) const
            && default_build_system == rhs.default_build_system
            && default_code_style == rhs.default_code_style
            && default_dist_path == rhs.default_dist_path
-           && custom_dist_path == rhs.custom_dist_path;
+           && custom_dist_path == rhs.custom_dist_path
+           && exclude_patterns == rhs.exclude_patterns
+           && lazy_project_tree == rhs.lazy_project_tree
+           && codeblocks_generator == rhs.codeblocks_generator;
 }
 
 // ------------------ ROSSettingsWidget
@@ -165,6 +179,17 @@ ROSSettings ROSSettingsWidget::settings() const
       rc.default_dist_path = Constants::ROS_INSTALL_DIRECTORY;
 
     rc.custom_dist_path = m_ui->customDistributionPathChooser->filePath().toString();
+
+    for (const QString &pattern : m_ui->excludePatternsLineEdit->text().split(QLatin1Char(';'), Qt::SkipEmptyParts))
+    {
+      const QString trimmed = pattern.trimmed();
+      if (!trimmed.isEmpty())
+        rc.exclude_patterns.append(trimmed);
+    }
+
+    rc.lazy_project_tree = m_ui->lazyProjectTreeCheckBox->isChecked();
+    rc.codeblocks_generator = m_ui->codeBlocksGeneratorCheckBox->isChecked();
+
     return rc;
 }
 
@@ -189,6 +214,9 @@ void ROSSettingsWidget::setSettings(const ROSSettings &s)
       m_ui->defaultDistributionPathChooser->setPath(s.default_dist_path);
 
     m_ui->customDistributionPathChooser->setPath(s.custom_dist_path);
+    m_ui->excludePatternsLineEdit->setText(s.exclude_patterns.join(QLatin1String("; ")));
+    m_ui->lazyProjectTreeCheckBox->setChecked(s.lazy_project_tree);
+    m_ui->codeBlocksGeneratorCheckBox->setChecked(s.codeblocks_generator);
 }
 
 // --------------- ROSSettingsPage
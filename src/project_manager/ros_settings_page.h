@@ -50,6 +50,12 @@ struct ROSSettings
 
     QString custom_dist_path;
 
+    QStringList exclude_patterns;
+
+    bool lazy_project_tree;
+
+    bool codeblocks_generator;
+
     void toSettings(Utils::QtcSettings *) const;
     void fromSettings(Utils::QtcSettings *);
 
@@ -19,21 +19,42 @@
  * limitations under the License.
  */
 #include "ros_utils.h"
+#include "ros_cmake_file_api.h"
+#include "ros_compile_commands.h"
 #include "ros_project_constants.h"
 #include "ros_packagexml_parser.h"
+#include "ros_package_index.h"
+#include "ros_package_info_cache.h"
 #include "ros_settings_page.h"
 #include "ros_project_plugin.h"
+#include "ros_workspace_scan_cache.h"
+#include "ros_directory_walker.h"
+#include "ros_path_filter.h"
 
 #include <utils/fileutils.h>
 #include <coreplugin/messagemanager.h>
+#include <projectexplorer/projectexplorer.h>
 #include <yaml-cpp/yaml.h>
+#include <atomic>
+#include <mutex>
 #include <fstream>
 #include <QDir>
 #include <QDebug>
 #include <QFile>
 #include <QTextStream>
-#include <QDirIterator>
+#include <QMutex>
+#include <QSet>
 #include <QStandardPaths>
+#include <QThread>
+#include <QtConcurrentMap>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
+
+#ifdef Q_OS_UNIX
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
 
 namespace ROSProjectManager {
 namespace Internal {
@@ -238,25 +259,28 @@ bool ROSUtils::initializeWorkspace(QProcess *process, const WorkspaceInfo &works
 
 bool ROSUtils::buildWorkspace(QProcess *process, const WorkspaceInfo &workspaceInfo)
 {
+    const QString generator = getCMakeGeneratorArgument(QString(), Utils::Environment(process->processEnvironment().toStringList()));
+    const QString cmakeArgs = generator.isEmpty() ? QString() : QLatin1String(" --cmake-args ") + generator;
+
     switch(workspaceInfo.buildSystem) {
     case CatkinMake:
     {
         process->setWorkingDirectory(workspaceInfo.path.toString());
-        process->start(QLatin1String("bash"), QStringList() << QLatin1String("-c") << QLatin1String("catkin_make --cmake-args -G \"CodeBlocks - Unix Makefiles\""));
+        process->start(QLatin1String("bash"), QStringList() << QLatin1String("-c") << QLatin1String("catkin_make") + cmakeArgs);
         process->waitForFinished();
         break;
     }
     case CatkinTools:
     {
         process->setWorkingDirectory(workspaceInfo.path.toString());
-        process->start(QLatin1String("bash"), QStringList() << QLatin1String("-c") << QLatin1String("catkin build --cmake-args -G \"CodeBlocks - Unix Makefiles\""));
+        process->start(QLatin1String("bash"), QStringList() << QLatin1String("-c") << QLatin1String("catkin build") + cmakeArgs);
         process->waitForFinished();
         break;
     }
     case Colcon:
     {
         process->setWorkingDirectory(workspaceInfo.path.toString());
-        process->start(QLatin1String("bash"), QStringList() << QLatin1String("-c") << QLatin1String("colcon build --cmake-args -G \"CodeBlocks - Unix Makefiles\""));
+        process->start(QLatin1String("bash"), QStringList() << QLatin1String("-c") << QLatin1String("colcon build") + cmakeArgs);
         process->waitForFinished();
         break;
     }
@@ -426,185 +450,469 @@ void ROSUtils::getDefaultFolderContentFilters(QStringList& folderNameFilters, QS
 {
   folderNameFilters.push_back("\\.git");
   fileNameFilters.push_back("^.*\\.autosave");
+  fileNameFilters.push_back("^.*\\.scancache(\\..*)?$"); // Includes the temporary file of QSaveFile
 }
 
-ROSUtils::FolderContent ROSUtils::getFolderContent(const QString &folder, const QStringList& folderNameFilters, const QStringList& fileNameFilters)
+ROSUtils::FolderContent ROSUtils::getFolderContent(const QString &folder)
 {
   ROSUtils::FolderContent content;
 
-  // Get Directory data
-  content.directories = QDir(folder).entryList(QDir::NoDotAndDotDot | QDir::Dirs | QDir::Hidden);
-  content.removeDirectories(folderNameFilters);
-
-  content.files = QDir(folder).entryList(QDir::NoDotAndDotDot | QDir::Files | QDir::Hidden);
-  content.removeFiles(fileNameFilters);
+#ifdef Q_OS_UNIX
+  // Read the directory once and classify the entries by the type returned with them,
+  // only symbolic links and file systems that do not report a type need a stat.
+  DIR *dir = ::opendir(QFile::encodeName(folder).constData());
+  if (!dir)
+    return content;
 
-  return content;
-}
+  while (const struct dirent *entry = ::readdir(dir))
+  {
+    const char *name = entry->d_name;
+    if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+      continue;
 
-QHash<QString, ROSUtils::FolderContent> ROSUtils::getFolderContentRecursive(const Utils::FilePath &folderPath, QStringList &fileList, QStringList& directoryList)
-{
-    QHash<QString, ROSUtils::FolderContent> workspaceFiles;
+    unsigned char type = entry->d_type;
+    if (type == DT_UNKNOWN || type == DT_LNK)
+    {
+      // Links are classified by their target, broken links are skipped like QDir does
+      struct stat st;
+      if (::fstatat(::dirfd(dir), name, &st, 0) != 0)
+        continue;
 
-    QString folder = folderPath.toString();
+      type = S_ISDIR(st.st_mode) ? DT_DIR : (S_ISREG(st.st_mode) ? DT_REG : DT_UNKNOWN);
+    }
 
-    // Need to remove unwanted directories
-    QStringList folderNameFilters, fileNameFilters;
-    getDefaultFolderContentFilters(folderNameFilters, fileNameFilters);
+    if (type == DT_DIR)
+      content.directories.append(QFile::decodeName(name));
+    else if (type == DT_REG)
+      content.files.append(QFile::decodeName(name));
+  }
+  ::closedir(dir);
 
-    const ROSUtils::FolderContent content = getFolderContent(folder, folderNameFilters, fileNameFilters);
+  // Same order as QDir::entryList
+  content.directories.sort(Qt::CaseInsensitive);
+  content.files.sort(Qt::CaseInsensitive);
+#else
+  // Get Directory data
+  const QDir dir(folder);
+  content.directories = dir.entryList(QDir::NoDotAndDotDot | QDir::Dirs | QDir::Hidden);
+  content.files = dir.entryList(QDir::NoDotAndDotDot | QDir::Files | QDir::Hidden);
+#endif
 
-    workspaceFiles[folder] = content;
+  return content;
+}
 
-    for (const QString& file : content.files)
-        fileList.append(QDir(folder).absoluteFilePath(file));
+ROSUtils::FolderContent ROSUtils::getFolderContent(const QString &folder, const ROSPathFilter &filter, const QString &rootPath)
+{
+  ROSUtils::FolderContent content = getFolderContent(folder);
+  ROSPathFilter::ScopePtr scope = filter.parentScope(rootPath, folder);
+  if (filter.apply(folder, content, scope))
+    ROSPathFilter::removeIgnoredDirectories(folder, content);
 
-    for (const QString& directory : content.directories)
-        directoryList.append(QDir(folder).absoluteFilePath(directory));
+  return content;
+}
 
-    // Get SubDirectory Information
-    const QDir subDir(folder);
-    QDirIterator itSrc(subDir.absolutePath(), QDir::NoDotAndDotDot | QDir::Dirs | QDir::Hidden, QDirIterator::Subdirectories | QDirIterator::FollowSymlinks);
-    QList<QString> excludeDir;
-    while (itSrc.hasNext())
-    {
-        folder = itSrc.next();
+QHash<QString, ROSUtils::FolderContent> ROSUtils::getFolderContentRecursive(const Utils::FilePath &folderPath, QStringList &fileList, QStringList& directoryList, const ROSPathFilter &filter, ROSWorkspaceScanCache *cache, QStringList *packagePaths, const QString &scopeRoot, const std::function<bool()> &isCanceled)
+{
+    const QString root = folderPath.toString();
+    QMutex packagePathsMutex;
+    QMutex ignoredMutex;
+    QStringList ignored;
+
+    // The index stores unfiltered listings so changing the filters never requires a rescan
+    ROSDirectoryWalker walker([&](const QString &folder, ROSPathFilter::ScopePtr &scope) {
+        ROSUtils::FolderContent content;
+        if (cache)
+        {
+            const ROSWorkspaceScanCache::DirectoryStamp stamp = ROSWorkspaceScanCache::directoryStamp(folder);
+            if (!cache->find(folder, stamp, content))
+                content = getFolderContent(folder);
 
-        QString folder_name = Utils::FilePath::fromString(folder).fileName();
-        bool found = false;
-        for (const auto& filter : qAsConst(folderNameFilters))
+            cache->insert(folder, stamp, content);
+        }
+        else
         {
-          QRegularExpression rx(filter);
-          if (rx.match(folder_name).hasMatch())
-          {
-            excludeDir.push_back(folder + QLatin1Char('/'));
-            found = true;
-            break;
-          }
+            content = getFolderContent(folder);
         }
 
-        if (found)
-          continue;
+        if (!filter.apply(folder, content, scope) && folder != root)
+        {
+            QMutexLocker locker(&ignoredMutex);
+            ignored.append(folder);
+        }
 
-        bool skip = false;
-        for (const QString& exclude : excludeDir)
+        // Package contents are loaded later, only the package directory itself is part of the result
+        if (packagePaths && folder != root && content.files.contains(QLatin1String("package.xml")))
         {
-            if (folder.startsWith(exclude))
-            {
-                skip = true;
-                break;
-            }
+            content.files.clear();
+            content.directories.clear();
+
+            QMutexLocker locker(&packagePathsMutex);
+            packagePaths->append(folder);
         }
 
-        if (skip) continue;
+        return content;
+    });
 
-        const ROSUtils::FolderContent content = getFolderContent(folder, folderNameFilters, fileNameFilters);
+    // Symbolic links are followed, a directory reachable through several links is only read once
+    walker.setSymlinkPolicy(ROSDirectoryWalker::SymlinkPolicy::FollowOnce);
+    walker.setCanceledFunction(isCanceled);
+    walker.setThreadPool(ProjectExplorer::ProjectExplorerPlugin::sharedThreadPool());
 
-        workspaceFiles[folder] = content;
+    const ROSPathFilter::ScopePtr scope = scopeRoot.isEmpty() ? ROSPathFilter::ScopePtr() : filter.parentScope(scopeRoot, root);
+    QHash<QString, ROSUtils::FolderContent> workspaceFiles = walker.walk(root, scope);
 
-        for (const QString& file : content.files)
-            fileList.append(QDir(folder).absoluteFilePath(file));
+    // Directories skipped by the build tools are not part of the listing of their parent
+    for (const QString &directory : std::as_const(ignored))
+    {
+        workspaceFiles.remove(directory);
 
-        for (const QString& directory : content.directories)
-            directoryList.append(QDir(folder).absoluteFilePath(directory));
+        const int separator = directory.lastIndexOf(QLatin1Char('/'));
+        auto parent = workspaceFiles.find(directory.left(separator));
+        if (parent != workspaceFiles.end())
+            parent.value().directories.removeOne(directory.mid(separator + 1));
+    }
+
+    for (auto it = workspaceFiles.constBegin(); it != workspaceFiles.constEnd(); ++it)
+    {
+        for (const QString& file : it.value().files)
+            fileList.append(it.key() + QLatin1Char('/') + file);
+
+        for (const QString& directory : it.value().directories)
+            directoryList.append(it.key() + QLatin1Char('/') + directory);
     }
 
     return workspaceFiles;
 }
 
-ROSUtils::PackageInfoMap ROSUtils::getWorkspacePackageInfo(const WorkspaceInfo &workspaceInfo, const PackageInfoMap *cachedPackageInfo)
+/**
+ * @brief Write messages to the general messages pane, from the GUI thread if called from a worker thread
+ * @param errors Messages that flash the pane
+ * @param messages Messages written silently
+ */
+static void writeMessagesOnGuiThread(const QStringList &errors, const QStringList &messages)
+{
+    if (errors.isEmpty() && messages.isEmpty())
+        return;
+
+    const auto write = [errors, messages]() {
+        for (const QString &error : errors)
+            Core::MessageManager::writeFlashing(error);
+
+        for (const QString &message : messages)
+            Core::MessageManager::writeSilently(message);
+    };
+
+    if (QThread::currentThread() == QCoreApplication::instance()->thread())
+        write();
+    else
+        QMetaObject::invokeMethod(QCoreApplication::instance(), write, Qt::QueuedConnection);
+}
+
+ROSUtils::PackageInfoMap ROSUtils::getWorkspacePackageInfo(const WorkspaceInfo &workspaceInfo, ROSPackageInfoCache *cache, ROSWorkspaceScanCache *scanCache, const Utils::Environment &environment,
+                                                           const std::function<bool()> &isCanceled)
 {
     PackageInfoMap wsPackageInfo;
-    QMap<QString, QString> packages =  ROSUtils::getWorkspacePackagePaths(workspaceInfo);
+    const QMap<QString, QString> packages =  ROSUtils::getWorkspacePackagePaths(workspaceInfo, scanCache);
+    const ROSPackageInfoCache::Entries previous = cache ? cache->entries() : ROSPackageInfoCache::Entries();
 
-    for(const auto& it : packages)
+    struct ParseResult
+    {
+        QString packagePath;
+        bool readable = false;
+        ROSPackageInfoCache::Entry entry;
+        QStringList diagnostics;
+    };
+
+    // Every package.xml is independent, the calling thread takes part so this may run on a pool thread.
+    // Only manifests that changed since the last call are parsed.
+    const QList<ParseResult> results = QtConcurrent::blockingMapped<QList<ParseResult>>(
+        ProjectExplorer::ProjectExplorerPlugin::sharedThreadPool(), packages.values(), [&previous, &environment](const QString &packagePath) {
+            ParseResult result;
+            result.packagePath = packagePath;
+            const auto it = previous.constFind(packagePath);
+            result.readable = ROSPackageInfoCache::refresh(packagePath, it == previous.constEnd() ? nullptr : &it.value(), environment, result.entry, result.diagnostics);
+            return result;
+        });
+
+    // Results are merged in package path order, so the map does not depend on scheduling
+    QStringList errors, messages;
+    ROSPackageInfoCache::Entries entries;
+    entries.reserve(results.size());
+    for (const ParseResult &result : results)
     {
-        Utils::FilePath pkgXml = Utils::FilePath::fromString(it).pathAppended("package.xml");
-        ROSUtils::PackageInfo packageInfo;
-        ROSPackageXmlParser pkgParser;
-        if (pkgParser.parsePackageXml(pkgXml, packageInfo))
+        messages.append(result.diagnostics);
+
+        const ROSUtils::PackageInfo &packageInfo = result.entry.packageInfo;
+        if (!result.readable)
         {
-            if (packageInfo.metapackage)
+            errors.append(QObject::tr("[ROS Error] Failed to parse file: %1.").arg(Utils::FilePath::fromString(result.packagePath).pathAppended("package.xml").toString()));
+
+            // Check if there is cached package info available
+            if (!result.entry.parsed)
                 continue;
 
-            wsPackageInfo.insert(packageInfo.name, packageInfo);
-            continue;
+            messages.append(QObject::tr("[ROS Info] Using cached package information for package: %1.").arg(packageInfo.name));
         }
 
-        // Check if there is cached build info available
-        if (cachedPackageInfo)
-        {
-            auto packIt = cachedPackageInfo->find(packageInfo.name);
-            if (packIt != cachedPackageInfo->end())
-            {
-                Core::MessageManager::writeSilently(QObject::tr("[ROS Info] Using cached package information for package: %1.").arg(packageInfo.name));
-                wsPackageInfo.insert(packIt.value().name, packIt.value());
-            }
-        }
+        entries.insert(result.packagePath, result.entry);
+        if (packageInfo.metapackage)
+            continue;
+
+        wsPackageInfo.insert(packageInfo.name, packageInfo);
     }
+
+    // A superseded update must not replace the entries of a newer one
+    if (cache)
+        cache->commit(entries, isCanceled);
+
+    writeMessagesOnGuiThread(errors, messages);
     return wsPackageInfo;
 }
 
+/**
+ * @brief Get the fingerprint of the files a package's build information was read from
+ *
+ * Covers the build directory, the File API reply directory, the CodeBlocks file, the
+ * compilation database, the codemodel reply and the flags.make file of every target.
+ * CMake rewrites these when a package is configured, not when it is only rebuilt.
+ */
+static QByteArray buildInfoFingerprint(const ROSUtils::WorkspaceInfo &workspaceInfo, const ROSUtils::PackageBuildInfo &buildInfo)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    const auto addStamp = [&hash](const Utils::FilePath &path) {
+        if (path.isEmpty())
+            return;
+
+        const ROSWorkspaceScanCache::DirectoryStamp stamp = ROSWorkspaceScanCache::directoryStamp(path.toString());
+        QByteArray data;
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out << path.toString() << stamp.mtime << stamp.inode << stamp.device;
+        hash.addData(data);
+    };
+
+    addStamp(buildInfo.path);
+    addStamp(ROSCMakeFileApi::cmakeBuildDirectory(workspaceInfo, buildInfo.path).pathAppended(QLatin1String(".cmake/api/v1/reply")));
+    addStamp(buildInfo.cbpFile);
+    addStamp(buildInfo.codemodelFile);
+    addStamp(buildInfo.compileCommandsFile);
+    for (const ROSUtils::PackageTargetInfoPtr &target : buildInfo.targets)
+        addStamp(target->flagsFile);
+
+    return hash.result();
+}
+
 ROSUtils::PackageBuildInfoMap ROSUtils::getWorkspacePackageBuildInfo(const WorkspaceInfo &workspaceInfo,
                                                                      const PackageInfoMap &packageInfo,
-                                                                     const PackageBuildInfoMap *cachedPackageBuildInfo)
+                                                                     const PackageBuildInfoMap *cachedPackageBuildInfo,
+                                                                     const QSet<QString> &reloadPackages,
+                                                                     const std::function<void(int, int)> &progress)
 {
-    PackageBuildInfoMap wsBuildInfo;
-    for (const PackageInfo& package : packageInfo)
+    struct ParseResult
     {
-        PackageBuildInfo buildInfo(package);
-        if (findPackageBuildDirectory(workspaceInfo, package, buildInfo.path))
-        {
-            // Get package's code block file
-            buildInfo.cbpFile = buildInfo.path.pathAppended(QString("%1.cbp").arg(package.name));
-
-            // If does not exist for default Project.cbp file
-            if (!buildInfo.cbpFile.exists())
+        PackageBuildInfo buildInfo{PackageInfo()};
+        bool parsed = false;
+        QStringList errors;
+        QStringList messages;
+    };
+
+    const int total = static_cast<int>(packageInfo.size());
+    std::atomic<int> finished{0};
+
+    // A catkin_make workspace has a single codemodel, it is read once by the first package that needs it
+    std::once_flag codemodelOnce;
+    ROSCMakeCodemodel workspaceCodemodel;
+    const auto codemodel = [&]() -> const ROSCMakeCodemodel * {
+        if (workspaceInfo.buildSystem != CatkinMake)
+            return nullptr;
+
+        std::call_once(codemodelOnce, [&]() {
+            QStringList packagePaths;
+            for (const PackageInfo &package : packageInfo)
+                packagePaths.append(package.path.toString());
+
+            workspaceCodemodel = ROSCMakeFileApi::readCodemodel(workspaceInfo.buildPath, packagePaths);
+        });
+        return &workspaceCodemodel;
+    };
+
+    // Every package is independent and reading its build directory is I/O bound. The number of
+    // packages read at once is bounded by the shared thread pool, the calling thread takes part.
+    const QList<ParseResult> results = QtConcurrent::blockingMapped<QList<ParseResult>>(
+        ProjectExplorer::ProjectExplorerPlugin::sharedThreadPool(), packageInfo.values(), [&](const PackageInfo &package) {
+            ParseResult result;
+
+            // Packages that were not configured since they were read last are reused
+            const PackageBuildInfo *cached = nullptr;
+            if (cachedPackageBuildInfo && !reloadPackages.contains(package.name))
             {
-              Utils::FilePath temp = buildInfo.path.pathAppended("Project.cbp");
-              if (temp.exists())
-                  buildInfo.cbpFile = temp;
+                const auto it = cachedPackageBuildInfo->constFind(package.name);
+                if (it != cachedPackageBuildInfo->constEnd())
+                    cached = &it.value();
             }
 
-            if (buildInfo.cbpFile.exists())
+            if (cached && cached->parent.path == package.path && !cached->fingerprint.isEmpty()
+                && buildInfoFingerprint(workspaceInfo, *cached) == cached->fingerprint)
             {
-                if (ROSUtils::parseCodeBlocksFile(workspaceInfo, buildInfo))
-                {
-                    wsBuildInfo.insert(package.name, buildInfo);
-                    continue;
-                }
-                else
-                {
-                    Core::MessageManager::writeSilently(QObject::tr("[ROS Warning] Unable to parse build information for package: %1.").arg(package.name));
-                }
+                result.buildInfo = *cached;
+                result.buildInfo.parent = package;
+                result.parsed = true;
             }
             else
             {
-                Core::MessageManager::writeSilently(QObject::tr("[ROS Warning] Unable to locate package %1 build file: %2.").arg(package.name, buildInfo.cbpFile.toString()));
+                result.buildInfo = PackageBuildInfo(package);
+                result.parsed = parsePackageBuildInfo(workspaceInfo, result.buildInfo, result.errors, result.messages, codemodel());
+                if (result.parsed)
+                    result.buildInfo.fingerprint = buildInfoFingerprint(workspaceInfo, result.buildInfo);
             }
-        }
-        else
+
+            if (progress)
+                progress(++finished, total);
+
+            return result;
+        });
+
+    // Results are merged in package name order, so the messages do not depend on scheduling
+    PackageBuildInfoMap wsBuildInfo;
+    QStringList errors, messages;
+    for (const ParseResult &result : results)
+    {
+        const QString &name = result.buildInfo.parent.name;
+        errors.append(result.errors);
+        messages.append(result.messages);
+        if (result.parsed)
         {
-            Core::MessageManager::writeSilently(QObject::tr("[ROS Warning] Unable to locate build directory for package: %1.").arg(package.name));
+            wsBuildInfo.insert(name, result.buildInfo);
+            continue;
         }
 
         // Check if there is cached build info available
         if (cachedPackageBuildInfo)
         {
-            auto packIt = cachedPackageBuildInfo->find(package.name);
+            auto packIt = cachedPackageBuildInfo->find(name);
             if (packIt != cachedPackageBuildInfo->end())
             {
-                Core::MessageManager::writeSilently(QObject::tr("[ROS Info] Using cached package build information for package: %1.").arg(package.name));
-                wsBuildInfo.insert(package.name, packIt.value());
+                messages.append(QObject::tr("[ROS Info] Using cached package build information for package: %1.").arg(name));
+                wsBuildInfo.insert(name, packIt.value());
             }
         }
-
     }
 
+    writeMessagesOnGuiThread(errors, messages);
     return wsBuildInfo;
 }
 
-bool ROSUtils::parseCodeBlocksFile(const WorkspaceInfo &workspaceInfo, ROSUtils::PackageBuildInfo &buildInfo)
+bool ROSUtils::parsePackageBuildInfo(const WorkspaceInfo &workspaceInfo,
+                                     PackageBuildInfo &buildInfo,
+                                     QStringList &errors,
+                                     QStringList &messages,
+                                     const ROSCMakeCodemodel *codemodel)
+{
+    const PackageInfo &package = buildInfo.parent;
+    if (!findPackageBuildDirectory(workspaceInfo, package, buildInfo.path))
+    {
+        messages.append(QObject::tr("[ROS Warning] Unable to locate build directory for package: %1.").arg(package.name));
+        return false;
+    }
+
+    // The CMake File API reply does not depend on the generator and has exact flags
+    if (codemodel ? ROSCMakeFileApi::readBuildInfo(workspaceInfo, *codemodel, buildInfo) : ROSCMakeFileApi::readBuildInfo(workspaceInfo, buildInfo))
+        return true;
+
+    // Ask for a reply on the next configure, until then the compilation database or CodeBlocks file is used
+    ROSCMakeFileApi::writeQuery(ROSCMakeFileApi::cmakeBuildDirectory(workspaceInfo, buildInfo.path));
+
+    if (ROSCompileCommands::readBuildInfo(workspaceInfo, buildInfo))
+        return true;
+
+    // Get package's code block file
+    buildInfo.cbpFile = buildInfo.path.pathAppended(QString("%1.cbp").arg(package.name));
+
+    // If does not exist for default Project.cbp file
+    if (!buildInfo.cbpFile.exists())
+    {
+      Utils::FilePath temp = buildInfo.path.pathAppended("Project.cbp");
+      if (temp.exists())
+          buildInfo.cbpFile = temp;
+    }
+
+    if (!buildInfo.cbpFile.exists())
+    {
+        messages.append(QObject::tr("[ROS Warning] Unable to locate package %1 build file: %2.").arg(package.name, buildInfo.cbpFile.toString()));
+        return false;
+    }
+
+    if (!ROSUtils::parseCodeBlocksFile(workspaceInfo, buildInfo, errors, messages))
+    {
+        messages.append(QObject::tr("[ROS Warning] Unable to parse build information for package: %1.").arg(package.name));
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Index the flags.make files of the CMake target directories below a package's build directory
+ *
+ * CMake lists every target directory in CMakeFiles/TargetDirectories.txt of the top level
+ * build directory, so no search is needed. Without it the build directory is walked once,
+ * target directories themselves are not entered.
+ *
+ * @param cmakeBuildDirectory The top level CMake build directory
+ * @param packageBuildPath The package's build directory
+ * @return QHash(Target Name, Path to flags.make), the first directory found for a target wins
+ */
+static QHash<QString, QString> targetFlagsFileIndex(const Utils::FilePath &cmakeBuildDirectory, const Utils::FilePath &packageBuildPath)
+{
+    QHash<QString, QString> index;
+    const QString packagePath = packageBuildPath.toString();
+    const auto add = [&index](const QString &directory) {
+        const QString name = directory.mid(directory.lastIndexOf(QLatin1Char('/')) + 1).chopped(4);
+        const QString flagsFile = directory + QLatin1String("/flags.make");
+        if (!index.contains(name) && QFileInfo::exists(flagsFile))
+            index.insert(name, flagsFile);
+    };
+
+    QFile targetDirectories(cmakeBuildDirectory.pathAppended(QLatin1String("CMakeFiles/TargetDirectories.txt")).toString());
+    if (targetDirectories.open(QFile::ReadOnly | QFile::Text))
+    {
+        QTextStream stream(&targetDirectories);
+        while (!stream.atEnd())
+        {
+            const QString directory = stream.readLine().trimmed();
+            if (directory.endsWith(QLatin1String(".dir")) && directory.startsWith(packagePath + QLatin1Char('/')))
+                add(directory);
+        }
+
+        return index;
+    }
+
+    QMutex directoriesMutex;
+    QStringList directories;
+    ROSDirectoryWalker walker([](const QString &folder, ROSPathFilter::ScopePtr &) {
+        ROSUtils::FolderContent content;
+        content.directories = QDir(folder).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+        return content;
+    });
+    walker.setEnterFunction([&](const QString &directory) {
+        if (!directory.endsWith(QLatin1String(".dir")))
+            return true;
+
+        QMutexLocker locker(&directoriesMutex);
+        directories.append(directory);
+        return false;
+    });
+    walker.setThreadPool(ProjectExplorer::ProjectExplorerPlugin::sharedThreadPool());
+    walker.walk(packagePath);
+
+    // Workers finish in any order, keep the result independent of scheduling
+    directories.sort();
+    for (const QString &directory : std::as_const(directories))
+        add(directory);
+
+    return index;
+}
+
+bool ROSUtils::parseCodeBlocksFile(const WorkspaceInfo &workspaceInfo, ROSUtils::PackageBuildInfo &buildInfo, QStringList &errors, QStringList &messages)
 {
   QMap<QString, PackageTargetInfoPtr> targetMap;
 
@@ -615,7 +923,7 @@ bool ROSUtils::parseCodeBlocksFile(const WorkspaceInfo &workspaceInfo, ROSUtils:
   QFile cbpFile(buildInfo.cbpFile.toString());
   if (!cbpFile.open(QFile::ReadOnly | QFile::Text))
   {
-    Core::MessageManager::writeFlashing(QObject::tr("[ROS Error] Error opening CodeBlocks Project File: %1.").arg(buildInfo.cbpFile.toString()));
+    errors.append(QObject::tr("[ROS Error] Error opening CodeBlocks Project File: %1.").arg(buildInfo.cbpFile.toString()));
     return false;
   }
 
@@ -629,6 +937,10 @@ bool ROSUtils::parseCodeBlocksFile(const WorkspaceInfo &workspaceInfo, ROSUtils:
 
   buildtimeInclude = buildtimeInclude.pathAppended(QLatin1String("include"));
 
+  // flags.make files of targets that are not in the working directory of the target
+  QHash<QString, QString> flagsFiles;
+  bool flagsFilesIndexed = false;
+
   cbpXml.setDevice(&cbpFile);
   cbpXml.readNext();
   while(!cbpXml.atEnd())
@@ -718,16 +1030,16 @@ bool ROSUtils::parseCodeBlocksFile(const WorkspaceInfo &workspaceInfo, ROSUtils:
             targetInfo->flagsFile = Utils::FilePath::fromString(targetWorkingDir).pathAppended("CMakeFiles").pathAppended(QString("%1.dir").arg(targetName)).pathAppended("flags.make");
             if (!targetInfo->flagsFile.exists())
             {
-                QDirIterator it(buildInfo.path.toString(), QStringList() << QString("%1.dir").arg(targetName), QDir::NoFilter, QDirIterator::Subdirectories);
-                while (it.hasNext())
+                // The index is built once per package and only if a target is not where it is expected
+                if (!flagsFilesIndexed)
                 {
-                    Utils::FilePath found_path = Utils::FilePath::fromString(it.next()).pathAppended("flags.make");
-                    if (found_path.exists())
-                    {
-                      targetInfo->flagsFile = found_path;
-                      break;
-                    }
+                    flagsFiles = targetFlagsFileIndex(ROSCMakeFileApi::cmakeBuildDirectory(workspaceInfo, buildInfo.path), buildInfo.path);
+                    flagsFilesIndexed = true;
                 }
+
+                const auto it = flagsFiles.constFind(targetName);
+                if (it != flagsFiles.constEnd())
+                    targetInfo->flagsFile = Utils::FilePath::fromString(it.value());
             }
 
             // The order matters so it will order local first then system
@@ -786,7 +1098,7 @@ bool ROSUtils::parseCodeBlocksFile(const WorkspaceInfo &workspaceInfo, ROSUtils:
           QFile flagsFile(it->flagsFile.toString());
           if (!flagsFile.open(QFile::ReadOnly | QFile::Text))
           {
-            Core::MessageManager::writeFlashing(QObject::tr("[ROS Error] Error opening flags file: %1.").arg(it->flagsFile.toString()));
+            errors.append(QObject::tr("[ROS Error] Error opening flags file: %1.").arg(it->flagsFile.toString()));
             it->flags.append(QLatin1String("-std=c++11"));
             continue;
           }
@@ -808,7 +1120,7 @@ bool ROSUtils::parseCodeBlocksFile(const WorkspaceInfo &workspaceInfo, ROSUtils:
       }
       else
       {
-          Core::MessageManager::writeSilently(QObject::tr("[ROS Warning] Flags file does not exist: %1.").arg(it->flagsFile.toString()));
+          messages.append(QObject::tr("[ROS Warning] Flags file does not exist: %1.").arg(it->flagsFile.toString()));
           it->flags.append(QLatin1String("-std=c++11"));
       }
   }
@@ -818,51 +1130,97 @@ bool ROSUtils::parseCodeBlocksFile(const WorkspaceInfo &workspaceInfo, ROSUtils:
 
 QMap<QString, QString> ROSUtils::getROSPackages(const QStringList &env)
 {
-  QProcess process;
-  QMap<QString, QString> package_map;
-  QStringList tmp;
+  // Read from the package index of the prefixes, no rospack or ros2 process is started
+  return ROSPackageIndex::packages(env);
+}
 
-  process.setEnvironment(env);
-  process.start(QLatin1String("bash"), QStringList());
-  process.waitForStarted();
-  QString cmd = QLatin1String("rospack list"); // TODO: for ROS2 do 'ros2 pkg list'
-  process.write(cmd.toLatin1());
-  process.closeWriteChannel();
-  process.waitForFinished();
+/**
+ * @brief Find files below a directory, following symbolic links without loops and reading each directory once
+ * @param root The directory to search
+ * @param nameFilters Wildcard patterns the file names must match
+ * @param filters Additional filters the files must match, e.g. QDir::Executable
+ * @param policy How symbolic links to directories are handled
+ * @return The sorted absolute paths of the matching files
+ */
+static QStringList findFilesRecursive(const QString &root,
+                                      const QStringList &nameFilters,
+                                      QDir::Filters filters = QDir::NoFilter,
+                                      ROSDirectoryWalker::SymlinkPolicy policy = ROSDirectoryWalker::SymlinkPolicy::FollowOnce)
+{
+    QMutex filesMutex;
+    QStringList files;
 
-  if (process.exitStatus() != QProcess::CrashExit)
-  {
-    QString output = QString::fromStdString(process.readAllStandardOutput().toStdString());
-    QStringList package_list = output.split(QRegularExpression("[\r\n]"), Qt::SkipEmptyParts);
+    ROSDirectoryWalker walker([&](const QString &folder, ROSPathFilter::ScopePtr &) {
+        const QDir dir(folder);
+        ROSUtils::FolderContent content;
+        content.directories = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
 
-    for (const QString& str : package_list)
-    {
-        tmp = str.split(QLatin1String(" "));
-        package_map.insert(tmp[0],tmp[1]);
-    }
+        const QStringList matches = dir.entryList(nameFilters, filters | QDir::Files | QDir::NoDotAndDotDot);
+        if (!matches.isEmpty())
+        {
+            QMutexLocker locker(&filesMutex);
+            for (const QString &file : matches)
+                files.append(folder + QLatin1Char('/') + file);
+        }
 
-    return package_map;
-  }
-  return QMap<QString, QString>();
+        return content;
+    });
+    walker.setSymlinkPolicy(policy);
+    walker.setThreadPool(ProjectExplorer::ProjectExplorerPlugin::sharedThreadPool());
+    walker.walk(root);
+
+    // Workers finish in any order, keep the result independent of scheduling
+    files.sort();
+    return files;
 }
 
-QMap<QString, QString> ROSUtils::getWorkspacePackagePaths(const WorkspaceInfo &workspaceInfo)
+QMap<QString, QString> ROSUtils::getWorkspacePackagePaths(const WorkspaceInfo &workspaceInfo, ROSWorkspaceScanCache *scanCache)
 {
     QMap<QString, QString> packageMap;
 
     const QDir srcDir(workspaceInfo.sourcePath.toString());
     if(srcDir.exists())
     {
-      QDirIterator it(srcDir.absolutePath(),QStringList() << QLatin1String("package.xml"), QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories | QDirIterator::FollowSymlinks);
-      while (it.hasNext())
-      {
-        QFileInfo packageFile(it.next());
-        packageMap.insert(packageFile.absoluteDir().dirName(), packageFile.absoluteDir().absolutePath());
-      }
+      QMutex packagePathsMutex;
+      QStringList packagePaths;
+
+      // The index is only read, waiting for a running scan keeps its listings consistent
+      QMutexLocker scanLocker(scanCache ? &scanCache->scanMutex() : nullptr);
+
+      ROSDirectoryWalker walker([&](const QString &folder, ROSPathFilter::ScopePtr &) {
+        // The index holds the unfiltered listings, only the ignore markers apply to discovery
+        ROSUtils::FolderContent content;
+        if (!scanCache || !scanCache->find(folder, ROSWorkspaceScanCache::directoryStamp(folder), content))
+          content = getFolderContent(folder);
+
+        for (const QString &file : std::as_const(content.files))
+        {
+          if (ROSPathFilter::isIgnoreMarker(file))
+            return ROSUtils::FolderContent();
+        }
+
+        // Packages are never nested, nothing below a package root is read
+        if (content.files.contains(QLatin1String("package.xml")))
+        {
+          QMutexLocker locker(&packagePathsMutex);
+          packagePaths.append(folder);
+          return ROSUtils::FolderContent();
+        }
+
+        content.files.clear();
+        return content;
+      });
+      walker.setThreadPool(ProjectExplorer::ProjectExplorerPlugin::sharedThreadPool());
+      walker.walk(srcDir.absolutePath());
+
+      // Duplicate package names resolve the same way on every call
+      packagePaths.sort();
+      for (const QString &packagePath : std::as_const(packagePaths))
+        packageMap.insert(QFileInfo(packagePath).fileName(), packagePath);
     }
     else
     {
-        Core::MessageManager::writeFlashing(QObject::tr("[ROS Error] Workspace source directory does not exist: %1.").arg(workspaceInfo.sourcePath.toString()));
+        writeMessagesOnGuiThread({QObject::tr("[ROS Error] Workspace source directory does not exist: %1.").arg(workspaceInfo.sourcePath.toString())}, QStringList());
     }
 
     return packageMap;
@@ -874,13 +1232,9 @@ QMap<QString, QString> ROSUtils::getROSPackageLaunchFiles(const QString &package
   if(!packagePath.isEmpty())
   {
     const QDir srcDir(packagePath);
-    QDirIterator it(srcDir.absolutePath(),QStringList() << QLatin1String("*.launch"), QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories | QDirIterator::FollowSymlinks);
-
-    while (it.hasNext())
-    {
-      QFileInfo launchFile(it.next());
-      launchFiles.insert(launchFile.fileName(), launchFile.absoluteFilePath());
-    }
+    const QStringList files = findFilesRecursive(srcDir.absolutePath(), QStringList() << QLatin1String("*.launch"));
+    for (const QString &file : files)
+      launchFiles.insert(QFileInfo(file).fileName(), file);
   }
 
   return launchFiles;
@@ -908,13 +1262,9 @@ QMap<QString, QString> ROSUtils::getROSPackageExecutables(const QString &package
     if (loc_list.size() > 0)
     {
       const QDir srcDir(loc_list[0]);
-      QDirIterator it(srcDir.absolutePath(), QDir::Files | QDir::Executable | QDir::NoDotAndDotDot, QDirIterator::Subdirectories | QDirIterator::FollowSymlinks);
-
-      while (it.hasNext())
-      {
-        QFileInfo executableFile(it.next());
-        package_executables.insert(executableFile.fileName(), executableFile.absoluteFilePath());
-      }
+      const QStringList files = findFilesRecursive(srcDir.absolutePath(), QStringList(), QDir::Executable);
+      for (const QString &file : files)
+        package_executables.insert(QFileInfo(file).fileName(), file);
 
       return package_executables;
     }
@@ -1143,6 +1493,18 @@ QString ROSUtils::getCMakeBuildTypeArgument(ROSUtils::BuildType &buildType)
     }
 }
 
+QString ROSUtils::getCMakeGeneratorArgument(const QString &cmakeArguments, const Utils::Environment &env)
+{
+    if (!ROSProjectPlugin::instance()->settings()->codeblocks_generator || env.hasKey(QLatin1String("CMAKE_GENERATOR")))
+        return QString();
+
+    static const QRegularExpression generatorArgument(QLatin1String("(^|\\s)-G"));
+    if (generatorArgument.match(cmakeArguments).hasMatch())
+        return QString();
+
+    return QLatin1String("-G \"CodeBlocks - Unix Makefiles\"");
+}
+
 ROSUtils::WorkspaceInfo ROSUtils::getWorkspaceInfo(const Utils::FilePath &workspaceDir,
                                                    const BuildSystem &buildSystem,
                                                    const Utils::FilePath &rosDistribution)
@@ -25,13 +25,20 @@
 #include <QProcessEnvironment>
 #include <QXmlStreamWriter>
 #include <QRegularExpression>
+#include <QSet>
 #include <utils/fileutils.h>
 #include <utils/environment.h>
+#include <functional>
 #include "ros_project_constants.h"
 
 namespace ROSProjectManager {
 namespace Internal {
 
+class ROSWorkspaceScanCache;
+class ROSPathFilter;
+class ROSPackageInfoCache;
+struct ROSCMakeCodemodel;
+
 class ROSUtils {
 public:
     ROSUtils();
@@ -57,26 +64,6 @@ public:
     struct FolderContent {
         QStringList files;       /**< @brief Directory Files */
         QStringList directories; /**< @brief Directory Subdirectories */
-
-        void removeDirectories(const QStringList &filters)
-        {
-            for (const QString& filter : filters)
-            {
-                QStringList remove_dirs = directories.filter(QRegularExpression(filter));
-                for (auto& d : remove_dirs)
-                    directories.removeAll(d);
-            }
-        }
-
-        void removeFiles(const QStringList &filters)
-        {
-            for (const QString& filter : filters)
-            {
-                QStringList remove_files = files.filter(QRegularExpression(filter));
-                for (auto& f : remove_files)
-                    files.removeAll(f);
-            }
-        }
     };
 
     /** @brief Contains relavent workspace information */
@@ -141,10 +128,13 @@ public:
             parent = packageInfo;
         }
 
-        Utils::FilePath path;          /**< @brief Path to the Package's build directory */
-        Utils::FilePath cbpFile;       /**< @brief Path to the Package's CodeBlocks file */
-        PackageTargetInfoList targets; /**< @brief List of packages target's */
-        PackageInfo parent;            /**< @brief Package information */
+        Utils::FilePath path;                /**< @brief Path to the Package's build directory */
+        Utils::FilePath cbpFile;             /**< @brief Path to the Package's CodeBlocks file */
+        Utils::FilePath codemodelFile;       /**< @brief Path to the Package's CMake File API codemodel reply */
+        Utils::FilePath compileCommandsFile; /**< @brief Path to the Package's compile_commands.json */
+        QByteArray fingerprint;              /**< @brief Stamps of the build files the information was read from */
+        PackageTargetInfoList targets;       /**< @brief List of packages target's */
+        PackageInfo parent;                  /**< @brief Package information */
 
         /**
          * @brief Check if build information exists.
@@ -252,25 +242,48 @@ public:
 
 
     /**
-     * @brief Get folder content for a given folder
+     * @brief Get the unfiltered folder content for a given folder
+     *
+     * On Unix the directory is read once and entries are classified by their directory entry
+     * type, only symbolic links and entries of unknown type are stat'ed.
+     *
      * @param folderPath Path to the foder
      * @return FolderContent FolderContent
      */
+    static FolderContent getFolderContent(const QString &folderPath);
+
+    /**
+     * @brief Get the filtered folder content for a given folder, subdirectories containing an ignore marker are not listed
+     * @param folderPath Path to the foder
+     * @param filter Filter to apply to the folder content
+     * @param rootPath The root of the scan the folder belongs to, used to find the .gitignore files that apply
+     * @return FolderContent FolderContent
+     */
     static FolderContent getFolderContent(const QString &folderPath,
-                                          const QStringList& folderNameFilters,
-                                          const QStringList& fileNameFilters);
+                                          const ROSPathFilter &filter,
+                                          const QString &rootPath);
 
     /**
      * @brief Gets all fo the files in a given folder
      * @param folderPath Path to the foder
      * @param fileList List of files in directory and sub directories
      * @param fileList List of sub directories
-     * @param recursive Process sub directoires
+     * @param filter Filter deciding which files and directories are part of the result
+     * @param cache Optional directory index, only directories whose metadata changed are listed again. Several
+     *              walks may share one scan of the index, ROSWorkspaceScanCache::beginScan() is called by the caller.
+     * @param packagePaths If not nullptr, package directories below folderPath are not entered and their paths are added to it
+     * @param scopeRoot If not empty, the .gitignore files from this directory down to folderPath are applied as well
+     * @param isCanceled If set, checked before each directory is read and the scan stops once it returns true
      * @return QHash<QString, FolderContent> Directory, FolderContent
      */
     static QHash<QString, FolderContent> getFolderContentRecursive(const Utils::FilePath &folderPath,
                                                                    QStringList &fileList,
-                                                                   QStringList &directoryList);
+                                                                   QStringList &directoryList,
+                                                                   const ROSPathFilter &filter,
+                                                                   ROSWorkspaceScanCache *cache = nullptr,
+                                                                   QStringList *packagePaths = nullptr,
+                                                                   const QString &scopeRoot = QString(),
+                                                                   const std::function<bool()> &isCanceled = std::function<bool()>());
 
     /**
      * @brief Get relevant workspace information
@@ -285,26 +298,37 @@ public:
     /**
      * @brief Get all of the workspace packages and its neccessary information.
      * @param workspaceInfo Workspace information
-     * @param cachedPackageInfo Cached Package information to use if it fails
+     * @param cache Optional package.xml cache, only changed manifests are parsed and the last parsed
+     *              information is used for manifests that can not be read. It is updated with the result.
+     * @param scanCache Optional index of the workspace scan, see getWorkspacePackagePaths
+     * @param environment The build environment the package.xml conditions are evaluated in
+     * @param isCanceled Optional, if it returns true once the manifests are read the cache is not updated
      * @return QMap(Package Name, PackageInfo)
      */
     static PackageInfoMap getWorkspacePackageInfo(const WorkspaceInfo &workspaceInfo,
-                                                  const PackageInfoMap *cachedPackageInfo = NULL);
+                                                  ROSPackageInfoCache *cache = nullptr,
+                                                  ROSWorkspaceScanCache *scanCache = nullptr,
+                                                  const Utils::Environment &environment = Utils::Environment(),
+                                                  const std::function<bool()> &isCanceled = std::function<bool()>());
 
     /**
-     * @brief Get a packages build information
+     * @brief Get a packages build information, the packages are read concurrently
      * @param workspaceInfo Workspace information
      * @param packageInfo Package Information
-     * @param cachedPackageBuildInfo Cached Package build information if it fails
+     * @param cachedPackageBuildInfo Cached Package build information, reused if the build files of a package did not change and used if it fails
+     * @param reloadPackages Packages that are read again even if their build files did not change
+     * @param progress Called with the number of finished and total packages after each package, called concurrently
      * @return PackageBuildInfo
      */
     static PackageBuildInfoMap getWorkspacePackageBuildInfo(const WorkspaceInfo &workspaceInfo,
                                                             const PackageInfoMap &packageInfo,
-                                                            const PackageBuildInfoMap *cachedPackageBuildInfo = NULL);
+                                                            const PackageBuildInfoMap *cachedPackageBuildInfo = NULL,
+                                                            const QSet<QString> &reloadPackages = QSet<QString>(),
+                                                            const std::function<void(int finished, int total)> &progress = {});
 
     /**
-     * @brief Executes the bash command "rospack list" and returns a map of QMap(Package Name, Path
-     * to package)
+     * @brief Get the packages available in an environment from the ament resource index (ROS 2)
+     * and the ROS_PACKAGE_PATH (ROS 1), see ROSPackageIndex
      * @param env Is the environment to use for getting the list of available packages.
      * @return QMap(Package Name, Path to package)
      */
@@ -312,10 +336,20 @@ public:
 
     /**
      * @brief Get the path to every package in the workspace.
+     *
+     * Like catkin and colcon, directories containing a package.xml are not descended into and
+     * directories containing a CATKIN_IGNORE, COLCON_IGNORE or AMENT_IGNORE marker are skipped.
+     *
+     * @param workspaceInfo Workspace information
+     * The project filters do not apply, packages in excluded or ignored directories are still built.
+     *
      * @param workspaceInfo Workspace information
+     * @param scanCache Optional index of the workspace scan, only directories missing from it or
+     *                  modified since are read from disk
      * @return QMap(Package Name, Path to package)
      */
-    static QMap<QString, QString> getWorkspacePackagePaths(const WorkspaceInfo &workspaceInfo);
+    static QMap<QString, QString> getWorkspacePackagePaths(const WorkspaceInfo &workspaceInfo,
+                                                           ROSWorkspaceScanCache *scanCache = nullptr);
 
     /**
      * @brief Gets all launch files associated to a package
@@ -420,6 +454,20 @@ public:
      */
     static QString getCMakeBuildTypeArgument(ROSUtils::BuildType &buildType);
 
+    /**
+     * @brief Get cmake generator argument
+     *
+     * Build information is read from the CMake File API, which works with any generator, so
+     * CMake's default generator or the one in CMAKE_GENERATOR is used. The CodeBlocks generator
+     * is only passed if the legacy option is enabled in the settings and the user selects no
+     * generator, for CMake versions too old to answer File API queries.
+     *
+     * @param cmakeArguments The user's cmake arguments
+     * @param env The build environment
+     * @return CMake generator argument, empty if CMake picks the generator
+     */
+    static QString getCMakeGeneratorArgument(const QString &cmakeArguments, const Utils::Environment &env);
+
     /**
      * @brief Get workspace environment
      * @param workspaceInfo Workspace information
@@ -428,6 +476,17 @@ public:
      */
     static QProcessEnvironment getWorkspaceEnvironment(const WorkspaceInfo &workspaceInfo, const Utils::Environment &current_environment);
 
+    /**
+     * @brief Find a given packages build directory
+     * @param workspaceInfo Workspace information
+     * @param packageInfo Package Information
+     * @param packageBuildPath Set to the package's build directory, even if it does not exist yet
+     * @return True if the build directory exists, otherwise false
+     */
+    static bool findPackageBuildDirectory(const WorkspaceInfo &workspaceInfo,
+                                          const PackageInfo &packageInfo,
+                                          Utils::FilePath &packageBuildPath);
+
 private:
     /**
      * @brief sourceWorkspaceHelper - Source workspace helper function
@@ -442,10 +501,29 @@ private:
      * @todo Need to figure out how to Cxx Flags.
      * @param workspaceInfo Workspace information
      * @param package Package Info Objects
+     * @param errors Error messages
+     * @param messages Warning messages
      * @return True if successful, otherwise false.
      */
     static bool parseCodeBlocksFile(const WorkspaceInfo &workspaceInfo,
-                                    PackageBuildInfo &package);
+                                    PackageBuildInfo &package,
+                                    QStringList &errors,
+                                    QStringList &messages);
+
+    /**
+     * @brief Get the build information of a single package, may be called from any thread
+     * @param workspaceInfo Workspace information
+     * @param buildInfo Package build information, the parent package must be set
+     * @param errors Error messages
+     * @param messages Warning messages
+     * @param codemodel Optional codemodel of the workspace build directory, read once for all packages of a catkin_make workspace
+     * @return True if successful, otherwise false.
+     */
+    static bool parsePackageBuildInfo(const WorkspaceInfo &workspaceInfo,
+                                      PackageBuildInfo &buildInfo,
+                                      QStringList &errors,
+                                      QStringList &messages,
+                                      const ROSCMakeCodemodel *codemodel = nullptr);
 
     /**
      * @brief Get path to the profiles directory
@@ -497,16 +575,6 @@ private:
      * @return False if the file does not exist or if the contents of the yaml file are not valid.
      */
     static bool isCatkinToolsProfileConfigValid(const Utils::FilePath& configPath);
-
-    /**
-     * @brief Find a given packages build directory
-     * @param workspaceInfo Workspace information
-     * @param packageInfo Package Information
-     * @return Packages build directory
-     */
-    static bool findPackageBuildDirectory(const WorkspaceInfo &workspaceInfo,
-                                          const PackageInfo &packageInfo,
-                                          Utils::FilePath &packageBuildPath);
 };
 } // namespace Internal
 } // namespace ROSProjectManager
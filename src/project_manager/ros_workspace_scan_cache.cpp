@@ -0,0 +1,227 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ros_workspace_scan_cache.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QSet>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+namespace ROSProjectManager {
+namespace Internal {
+
+// Increment whenever the layout of the index file or of FolderContent changes
+static const quint32 SCAN_CACHE_MAGIC = 0x524f5343; // "ROSC"
+static const quint32 SCAN_CACHE_VERSION = 2;
+
+// Directories modified this close to the start of a scan may change again within the
+// same timestamp tick, so their listing is not trusted on the next scan.
+static const qint64 SCAN_CACHE_RACY_WINDOW_NS = 2000000000LL;
+
+bool ROSWorkspaceScanCache::DirectoryStamp::isRacy(qint64 time) const
+{
+    return !isValid() || mtime >= (time - SCAN_CACHE_RACY_WINDOW_NS);
+}
+
+bool ROSWorkspaceScanCache::DirectoryStamp::operator==(const DirectoryStamp &other) const
+{
+    return mtime == other.mtime && inode == other.inode && device == other.device;
+}
+
+ROSWorkspaceScanCache::ROSWorkspaceScanCache(const Utils::FilePath &cacheFile) :
+    m_cacheFile(cacheFile),
+    m_scanStart(0),
+    m_loaded(false),
+    m_dirty(false)
+{
+}
+
+Utils::FilePath ROSWorkspaceScanCache::cacheFilePath(const Utils::FilePath &projectFilePath)
+{
+    return projectFilePath.stringAppended(QLatin1String(".scancache"));
+}
+
+ROSWorkspaceScanCache::DirectoryStamp ROSWorkspaceScanCache::directoryStamp(const QString &directory)
+{
+    DirectoryStamp stamp;
+#ifdef Q_OS_UNIX
+    struct stat st;
+    if (::stat(QFile::encodeName(directory).constData(), &st) != 0)
+        return stamp;
+
+#ifdef Q_OS_MACOS
+    stamp.mtime = static_cast<qint64>(st.st_mtimespec.tv_sec) * 1000000000LL + st.st_mtimespec.tv_nsec;
+#else
+    stamp.mtime = static_cast<qint64>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+#endif
+    stamp.inode = static_cast<quint64>(st.st_ino);
+    stamp.device = static_cast<quint64>(st.st_dev);
+#else
+    const QFileInfo info(directory);
+    if (!info.exists())
+        return stamp;
+
+    stamp.mtime = info.lastModified().toMSecsSinceEpoch() * 1000000LL;
+#endif
+    return stamp;
+}
+
+bool ROSWorkspaceScanCache::load()
+{
+    m_previous.clear();
+    m_root.clear();
+    m_loaded = true;
+
+    QFile file(m_cacheFile.toString());
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (magic != SCAN_CACHE_MAGIC || version != SCAN_CACHE_VERSION)
+        return false;
+
+    QString root;
+    qint32 count = 0;
+    in >> root >> count;
+
+    QHash<QString, Entry> entries;
+    entries.reserve(count);
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+    {
+        QString directory;
+        Entry entry;
+        in >> directory >> entry.stamp.mtime >> entry.stamp.inode >> entry.stamp.device
+           >> entry.content.files >> entry.content.directories;
+        entries.insert(directory, entry);
+    }
+
+    // A truncated or corrupt index is treated as missing
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    m_root = root;
+    m_previous = std::move(entries);
+    return true;
+}
+
+bool ROSWorkspaceScanCache::save()
+{
+    // Nothing was re-listed and no directory disappeared, the file on disk is still valid
+    if (!m_dirty && m_current.size() == m_previous.size())
+        return true;
+
+    QSaveFile file(m_cacheFile.toString());
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << SCAN_CACHE_MAGIC << SCAN_CACHE_VERSION << m_root << static_cast<qint32>(m_current.size());
+    for (auto it = m_current.constBegin(); it != m_current.constEnd(); ++it)
+    {
+        out << it.key() << it.value().stamp.mtime << it.value().stamp.inode << it.value().stamp.device
+            << it.value().content.files << it.value().content.directories;
+    }
+
+    if (out.status() != QDataStream::Ok || !file.commit())
+        return false;
+
+    // The entries of this scan become the reference for the next scan
+    m_previous = m_current;
+    m_dirty = false;
+    return true;
+}
+
+void ROSWorkspaceScanCache::beginScan(const QString &root)
+{
+    if (root != m_root)
+    {
+        m_previous.clear();
+        m_root = root;
+    }
+
+    m_current.clear();
+    m_current.reserve(m_previous.size());
+    m_scanStart = QDateTime::currentMSecsSinceEpoch() * 1000000LL;
+    m_dirty = false;
+}
+
+bool ROSWorkspaceScanCache::find(const QString &directory, const DirectoryStamp &stamp, ROSUtils::FolderContent &content) const
+{
+    auto it = m_previous.constFind(directory);
+    if (!stamp.isValid() || it == m_previous.constEnd() || it.value().stamp != stamp)
+        return false;
+
+    content = it.value().content;
+    return true;
+}
+
+void ROSWorkspaceScanCache::insert(const QString &directory, const DirectoryStamp &stamp, const ROSUtils::FolderContent &content)
+{
+    const bool racy = stamp.isRacy(m_scanStart);
+
+    auto it = m_previous.constFind(directory);
+    const bool changed = racy || it == m_previous.constEnd() || it.value().stamp != stamp;
+
+    QMutexLocker locker(&m_currentMutex);
+    if (changed)
+        m_dirty = true;
+
+    if (!racy)
+        m_current.insert(directory, {stamp, content});
+}
+
+void ROSWorkspaceScanCache::keepSubtrees(const QStringList &directories)
+{
+    const QSet<QString> roots(directories.begin(), directories.end());
+
+    QMutexLocker locker(&m_currentMutex);
+    for (auto it = m_previous.constBegin(); it != m_previous.constEnd(); ++it)
+    {
+        if (m_current.contains(it.key()))
+            continue;
+
+        QString path = it.key();
+        for (path.truncate(path.lastIndexOf(QLatin1Char('/'))); !path.isEmpty(); path.truncate(path.lastIndexOf(QLatin1Char('/'))))
+        {
+            if (roots.contains(path))
+            {
+                m_current.insert(it.key(), it.value());
+                break;
+            }
+        }
+    }
+}
+
+} // namespace Internal
+} // namespace ROSProjectManager
@@ -0,0 +1,164 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ROS_WORKSPACE_SCAN_CACHE_H
+#define ROS_WORKSPACE_SCAN_CACHE_H
+
+#include "ros_utils.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+namespace ROSProjectManager {
+namespace Internal {
+
+/**
+ * @brief On-disk index of the workspace directory listings.
+ *
+ * The unfiltered listing of every scanned directory is stored together with its
+ * modification time and inode. When a project is reopened only the directories whose metadata no
+ * longer matches the index have to be listed again.
+ *
+ * find() and insert() may be called concurrently while a scan is running. Outside of a scan, e.g.
+ * to read or load a package on demand, they may be called while holding scanMutex().
+ */
+class ROSWorkspaceScanCache
+{
+public:
+    /** @brief The directory metadata used to validate a cached listing */
+    struct DirectoryStamp {
+        qint64 mtime = 0;   /**< @brief Modification time in nanoseconds since epoch */
+        quint64 inode = 0;  /**< @brief Inode number, zero if not supported by the platform */
+        quint64 device = 0; /**< @brief Device id, zero if not supported by the platform */
+
+        bool isValid() const { return mtime != 0; }
+
+        /**
+         * @brief Check if the directory was modified too close to a given time for the stamp to be trusted later
+         * @param time The time the directory was read in nanoseconds since epoch
+         * @return True if a later change within the same timestamp tick would keep the same stamp
+         */
+        bool isRacy(qint64 time) const;
+
+        bool operator==(const DirectoryStamp &other) const;
+        bool operator!=(const DirectoryStamp &other) const { return !(*this == other); }
+    };
+
+    /**
+     * @brief Constructor
+     * @param cacheFile Path to the index file
+     */
+    explicit ROSWorkspaceScanCache(const Utils::FilePath &cacheFile);
+
+    /**
+     * @brief Get the index file used for a given project file
+     * @param projectFilePath The project (.workspace) file
+     * @return Path to the index file stored next to the project file
+     */
+    static Utils::FilePath cacheFilePath(const Utils::FilePath &projectFilePath);
+
+    /**
+     * @brief Get the metadata of a directory, also used for files
+     * @param directory Path to the directory
+     * @return The directory stamp, invalid if the directory could not be read
+     */
+    static DirectoryStamp directoryStamp(const QString &directory);
+
+    /**
+     * @brief Load the index from disk, discarding it if the version does not match
+     * @return True if the index was loaded, otherwise false
+     */
+    bool load();
+
+    /**
+     * @brief Check if load() has already been called
+     * @return True if the index was read from disk or found to be missing, otherwise false
+     */
+    bool isLoaded() const { return m_loaded; }
+
+    /**
+     * @brief Save the directories recorded since the last scan started
+     * @return True if successful, otherwise false
+     */
+    bool save();
+
+    /**
+     * @brief Start a new scan of the given root directory.
+     *
+     * Directories not visited again before save() is called are dropped from the index.
+     *
+     * @param root The directory being scanned
+     */
+    void beginScan(const QString &root);
+
+    /**
+     * @brief Look up a directory listing
+     * @param directory Directory path
+     * @param stamp The current metadata of the directory
+     * @param content Populated with the cached listing if found
+     * @return True if the cached listing is still valid, otherwise false
+     */
+    bool find(const QString &directory, const DirectoryStamp &stamp, ROSUtils::FolderContent &content) const;
+
+    /**
+     * @brief Record a directory listing for the current scan
+     * @param directory Directory path
+     * @param stamp The metadata of the directory when it was listed
+     * @param content The directory listing
+     */
+    void insert(const QString &directory, const DirectoryStamp &stamp, const ROSUtils::FolderContent &content);
+
+    /**
+     * @brief Keep the indexed listings below directories the current scan does not descend into
+     *
+     * Used for packages whose content is loaded on demand, so their listings survive the scan.
+     *
+     * @param directories The directories whose subdirectories are kept
+     */
+    void keepSubtrees(const QStringList &directories);
+
+    /**
+     * @brief Get the mutex held for the whole duration of a scan, scans and users outside of a scan take turns
+     * @return The mutex
+     */
+    QMutex &scanMutex() { return m_scanMutex; }
+
+private:
+    struct Entry {
+        DirectoryStamp stamp;
+        ROSUtils::FolderContent content;
+    };
+
+    Utils::FilePath m_cacheFile;
+    QString m_root;
+    QHash<QString, Entry> m_previous; /**< @brief Entries loaded from disk or from the previous scan */
+    QHash<QString, Entry> m_current;  /**< @brief Entries recorded during the current scan */
+    QMutex m_currentMutex;            /**< @brief Guards m_current and m_dirty during a scan */
+    QMutex m_scanMutex;
+    qint64 m_scanStart;
+    bool m_loaded;
+    bool m_dirty;
+};
+
+} // namespace Internal
+} // namespace ROSProjectManager
+
+#endif // ROS_WORKSPACE_SCAN_CACHE_H
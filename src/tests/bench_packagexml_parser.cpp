@@ -0,0 +1,314 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ros_packagexml_parser.h"
+
+#include <QDirIterator>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtTest>
+
+using namespace ROSProjectManager::Internal;
+
+namespace {
+
+/**
+ * @brief The package.xml parser before the tag table, kept as the reference of the benchmark.
+ *
+ * Compares the element names as allocated strings and deduplicates dependencies by scanning
+ * the lists. Writing to the message manager is left out, the files of the benchmark exist.
+ */
+class LegacyPackageXmlParser : public QXmlStreamReader
+{
+public:
+    bool parsePackageXml(const Utils::FilePath &filepath, ROSUtils::PackageInfo &packageInfo)
+    {
+        m_packageInfo = ROSUtils::PackageInfo();
+        m_packageInfo.path = filepath.parentDir();
+        m_packageInfo.filepath = filepath;
+        m_packageInfo.buildFile = m_packageInfo.path.pathAppended("CMakeLists.txt");
+
+        QFile pkgFile(filepath.toString());
+        if (!pkgFile.exists() || !pkgFile.open(QFile::ReadOnly))
+            return false;
+
+        setDevice(&pkgFile);
+        while (!atEnd()) {
+            readNext();
+            if (name().toString() == "package")
+                parse();
+            else if (isStartElement())
+                parseUnknownElement();
+        }
+
+        setDevice(nullptr);
+        packageInfo = m_packageInfo;
+        return true;
+    }
+
+private:
+    void parse()
+    {
+        while (!atEnd()) {
+            readNext();
+            if (isEndElement())
+                return;
+            else if (name().toString() == "name")
+                m_packageInfo.name = readElementText().trimmed();
+            else if (name().toString() == "version")
+                m_packageInfo.version = readElementText().trimmed();
+            else if (name().toString() == "description")
+                m_packageInfo.description = readElementText().trimmed();
+            else if (name().toString() == "maintainer")
+                m_packageInfo.maintainer = readElementText().trimmed();
+            else if (name().toString() == "license")
+                m_packageInfo.license = readElementText().trimmed();
+            else if (name().toString() == "depend")
+                parseDepend();
+            else if (name().toString() == "build_depend")
+                append(m_packageInfo.buildDepends, readElementText().trimmed());
+            else if (name().toString() == "buildtool_depend")
+                m_packageInfo.buildToolDepend = readElementText().trimmed();
+            else if (name().toString() == "build_export_depend")
+                append(m_packageInfo.buildExportDepends, readElementText().trimmed());
+            else if (name().toString() == "exec_depend")
+                append(m_packageInfo.execDepends, readElementText().trimmed());
+            else if (name().toString() == "run_depend")
+                append(m_packageInfo.execDepends, readElementText().trimmed());
+            else if (name().toString() == "test_depend")
+                append(m_packageInfo.testDepends, readElementText().trimmed());
+            else if (name().toString() == "doc_depend")
+                append(m_packageInfo.docDepends, readElementText().trimmed());
+            else if (name().toString() == "export")
+                parseExport();
+            else if (isStartElement())
+                parseUnknownElement();
+        }
+    }
+
+    void parseDepend()
+    {
+        const QString value = readElementText().trimmed();
+        append(m_packageInfo.buildDepends, value);
+        append(m_packageInfo.buildExportDepends, value);
+        append(m_packageInfo.execDepends, value);
+    }
+
+    void parseExport()
+    {
+        while (!atEnd()) {
+            readNext();
+            if (isEndElement())
+                return;
+            else if (name().toString() == "metapackage")
+                m_packageInfo.metapackage = true;
+            else if (isStartElement())
+                parseUnknownElement();
+        }
+    }
+
+    void parseUnknownElement()
+    {
+        while (!atEnd()) {
+            readNext();
+
+            if (isEndElement())
+                break;
+
+            if (isStartElement())
+                parseUnknownElement();
+        }
+    }
+
+    static void append(QStringList &list, const QString &value)
+    {
+        if (!list.contains(value))
+            list.push_back(value);
+    }
+
+    ROSUtils::PackageInfo m_packageInfo;
+};
+
+} // namespace
+
+/**
+ * @brief Benchmark of parsing the package.xml files of a large workspace.
+ *
+ * Both parsers read the manifests from disk, after the first iteration they are served from
+ * the page cache. If the ROS_BENCHMARK_WORKSPACE environment variable is set, every
+ * package.xml below that directory is used, otherwise a few thousand generated manifests.
+ */
+class PackageXmlParserBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void sameResult();
+    void parse_data();
+    void parse();
+
+private:
+    static QByteArray generateManifest(int package);
+
+    QTemporaryDir m_workspace;
+    QList<QPair<Utils::FilePath, QByteArray>> m_manifests; /**< @brief Path, content */
+};
+
+static const int GENERATED_PACKAGE_COUNT = 5000;
+
+QByteArray PackageXmlParserBenchmark::generateManifest(int package)
+{
+    QString content = QString("<?xml version=\"1.0\"?>\n"
+                              "<?xml-model href=\"http://download.ros.org/schema/package_format3.xsd\" schematypens=\"http://www.w3.org/2001/XMLSchema\"?>\n"
+                              "<package format=\"%1\">\n"
+                              "  <name>pkg_%2</name>\n"
+                              "  <version>1.%2.0</version>\n"
+                              "  <description>Generated benchmark package %2</description>\n"
+                              "  <maintainer email=\"dev@example.com\">dev</maintainer>\n"
+                              "  <license>Apache-2.0</license>\n"
+                              "  <url type=\"website\">http://example.com/pkg_%2</url>\n"
+                              "  <author>dev</author>\n").arg(package % 3 + 1).arg(package);
+
+    if (package % 3 == 2)
+    {
+        content += QLatin1String("  <buildtool_depend condition=\"$ROS_VERSION == 1\">catkin</buildtool_depend>\n"
+                                 "  <buildtool_depend condition=\"$ROS_VERSION == 2\">ament_cmake</buildtool_depend>\n");
+    }
+    else
+    {
+        content += QLatin1String("  <buildtool_depend>catkin</buildtool_depend>\n");
+    }
+
+    // A typical manifest lists a few dozen dependencies, many of them twice
+    for (int i = 0; i < 30; ++i)
+    {
+        const QString dependency = QString("dep_%1").arg((package + i * 7) % 200);
+        if (package % 3 == 0)
+            content += QString("  <build_depend>%1</build_depend>\n  <run_depend>%1</run_depend>\n").arg(dependency);
+        else
+            content += QString("  <depend>%1</depend>\n  <exec_depend>%1</exec_depend>\n").arg(dependency);
+    }
+
+    content += QLatin1String("  <test_depend>gtest</test_depend>\n"
+                             "  <doc_depend>doxygen</doc_depend>\n"
+                             "  <export>\n"
+                             "    <build_type>ament_cmake</build_type>\n"
+                             "  </export>\n"
+                             "</package>\n");
+    return content.toUtf8();
+}
+
+void PackageXmlParserBenchmark::initTestCase()
+{
+    const QString workspace = qEnvironmentVariable("ROS_BENCHMARK_WORKSPACE");
+    if (!workspace.isEmpty())
+    {
+        QDirIterator it(workspace, QStringList() << QLatin1String("package.xml"), QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext())
+        {
+            const QString path = it.next();
+            QFile file(path);
+            if (file.open(QFile::ReadOnly))
+                m_manifests.append({Utils::FilePath::fromString(path), file.readAll()});
+        }
+        QVERIFY2(!m_manifests.isEmpty(), "No package.xml found below ROS_BENCHMARK_WORKSPACE");
+    }
+    else
+    {
+        QVERIFY(m_workspace.isValid());
+        for (int i = 0; i < GENERATED_PACKAGE_COUNT; ++i)
+        {
+            const QString directory = m_workspace.path() + QString("/src/pkg_%1").arg(i);
+            QVERIFY(QDir().mkpath(directory));
+
+            QFile file(directory + QLatin1String("/package.xml"));
+            const QByteArray content = generateManifest(i);
+            QVERIFY(file.open(QFile::WriteOnly) && file.write(content) == content.size());
+            m_manifests.append({Utils::FilePath::fromString(file.fileName()), content});
+        }
+    }
+
+    qDebug("Parsing %lld manifests", static_cast<long long>(m_manifests.size()));
+}
+
+void PackageXmlParserBenchmark::sameResult()
+{
+    // Manifests without conditions must give the same information as before
+    for (const auto &manifest : std::as_const(m_manifests))
+    {
+        if (manifest.second.contains("condition="))
+            continue;
+
+        ROSUtils::PackageInfo legacyInfo, info;
+        LegacyPackageXmlParser legacy;
+        QVERIFY(legacy.parsePackageXml(manifest.first, legacyInfo));
+        ROSPackageXmlParser parser;
+        QVERIFY(parser.parsePackageXml(manifest.first, info));
+
+        QCOMPARE(info.name, legacyInfo.name);
+        QCOMPARE(info.version, legacyInfo.version);
+        QCOMPARE(info.buildToolDepend, legacyInfo.buildToolDepend);
+        QCOMPARE(info.buildDepends, legacyInfo.buildDepends);
+        QCOMPARE(info.buildExportDepends, legacyInfo.buildExportDepends);
+        QCOMPARE(info.execDepends, legacyInfo.execDepends);
+        QCOMPARE(info.testDepends, legacyInfo.testDepends);
+        QCOMPARE(info.docDepends, legacyInfo.docDepends);
+        QCOMPARE(info.metapackage, legacyInfo.metapackage);
+    }
+}
+
+void PackageXmlParserBenchmark::parse_data()
+{
+    QTest::addColumn<bool>("legacy");
+
+    QTest::newRow("legacy") << true;
+    QTest::newRow("tag table") << false;
+}
+
+void PackageXmlParserBenchmark::parse()
+{
+    QFETCH(bool, legacy);
+
+    Utils::Environment environment;
+    environment.set(QLatin1String("ROS_VERSION"), QLatin1String("2"));
+
+    QBENCHMARK {
+        for (const auto &manifest : std::as_const(m_manifests))
+        {
+            ROSUtils::PackageInfo info;
+            if (legacy)
+            {
+                LegacyPackageXmlParser parser;
+                parser.parsePackageXml(manifest.first, info);
+            }
+            else
+            {
+                ROSPackageXmlParser parser;
+                parser.setEnvironment(environment);
+                parser.parsePackageXml(manifest.first, info);
+            }
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(PackageXmlParserBenchmark)
+
+#include "bench_packagexml_parser.moc"
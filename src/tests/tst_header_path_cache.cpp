@@ -0,0 +1,123 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ros_header_path_cache.h"
+
+#include <QAtomicInt>
+#include <QTemporaryDir>
+#include <QThreadPool>
+#include <QtTest>
+
+using namespace ROSProjectManager::Internal;
+
+/**
+ * @brief Test of the built-in header path cache shared by the code model updates of all projects of a kit.
+ */
+class HeaderPathCacheTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void concurrentLookups();
+    void relevantFlags_data();
+    void relevantFlags();
+
+private:
+    QTemporaryDir m_directory;
+};
+
+void HeaderPathCacheTest::initTestCase()
+{
+    QVERIFY(m_directory.isValid());
+}
+
+void HeaderPathCacheTest::concurrentLookups()
+{
+    const Utils::FilePath cacheFile = Utils::FilePath::fromString(m_directory.path() + QLatin1String("/headerpaths.cache"));
+    QAtomicInt runs;
+    QAtomicInt failures;
+    const ProjectExplorer::ToolChain::BuiltInHeaderPathsRunner runner = [&runs](const QStringList &flags, const Utils::FilePath &, const QString &) {
+        runs.fetchAndAddOrdered(1);
+        return ProjectExplorer::HeaderPaths{ProjectExplorer::HeaderPath(QLatin1String("/usr/include/") + flags.join(QLatin1Char('_')),
+                                                                        ProjectExplorer::HeaderPathType::BuiltIn)};
+    };
+
+    // Many targets share two configurations, only the relevant flags are part of the key
+    QList<QStringList> targetFlags;
+    for (int i = 0; i < 1000; ++i)
+        targetFlags.append({QString("-std=c++%1").arg(i % 2 ? 17 : 14), QString("-DTARGET_%1").arg(i), QLatin1String("-O2")});
+
+    const int threadCount = 8;
+    {
+        ROSHeaderPathCache cache(cacheFile);
+        QThreadPool pool;
+        pool.setMaxThreadCount(threadCount);
+        for (const QStringList &flags : std::as_const(targetFlags))
+        {
+            pool.start([&cache, &runner, &failures, flags]() {
+                if (cache.headerPaths("toolchain", flags, Utils::FilePath(), runner).size() != 1)
+                    failures.fetchAndAddOrdered(1);
+            });
+        }
+        pool.waitForDone();
+
+        // Concurrent misses of the same configuration may each run the compiler once
+        QCOMPARE(failures.loadRelaxed(), 0);
+        QVERIFY(runs.loadRelaxed() >= 2);
+        QVERIFY(runs.loadRelaxed() <= 2 * threadCount);
+        QVERIFY(cache.save());
+    }
+
+    // A new session reads the configurations back and never runs the compiler
+    runs.storeRelaxed(0);
+    ROSHeaderPathCache cache(cacheFile);
+    QVERIFY(cache.load());
+    for (const QStringList &flags : std::as_const(targetFlags))
+        QCOMPARE(cache.headerPaths("toolchain", flags, Utils::FilePath(), runner).size(), 1);
+
+    QCOMPARE(runs.loadRelaxed(), 0);
+}
+
+void HeaderPathCacheTest::relevantFlags_data()
+{
+    QTest::addColumn<QStringList>("flags");
+    QTest::addColumn<QStringList>("relevant");
+
+    QTest::newRow("defines and optimization") << QStringList{"-DFOO", "-O2", "-Wall"} << QStringList();
+    QTest::newRow("standard") << QStringList{"-std=c++17", "-DFOO"} << QStringList{"-std=c++17"};
+    QTest::newRow("standard library") << QStringList{"-stdlib=libc++", "--stdlib=libstdc++"} << QStringList{"-stdlib=libc++", "--stdlib=libstdc++"};
+    QTest::newRow("spec file") << QStringList{"-specs=nano.specs", "--specs=rdimon.specs"} << QStringList{"-specs=nano.specs", "--specs=rdimon.specs"};
+    QTest::newRow("separate values") << QStringList{"-target", "aarch64-linux-gnu", "--sysroot", "/opt/sysroot", "-I/usr/include"}
+                                     << QStringList{"-target", "aarch64-linux-gnu", "--sysroot", "/opt/sysroot"};
+    QTest::newRow("machine") << QStringList{"-m32", "-march=native", "-nostdinc++"} << QStringList{"-m32", "-march=native", "-nostdinc++"};
+}
+
+void HeaderPathCacheTest::relevantFlags()
+{
+    QFETCH(QStringList, flags);
+    QFETCH(QStringList, relevant);
+
+    QCOMPARE(ROSHeaderPathCache::relevantFlags(flags), relevant);
+}
+
+QTEST_GUILESS_MAIN(HeaderPathCacheTest)
+
+#include "tst_header_path_cache.moc"
@@ -0,0 +1,139 @@
+/**
+ * @author agent
+ * @date October 17, 2026
+ *
+ * @copyright Copyright (c) 2026, Southwest Research Institute
+ *
+ * @license Software License Agreement (Apache License)\n
+ * \n
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at\n
+ * \n
+ * http://www.apache.org/licenses/LICENSE-2.0\n
+ * \n
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ros_package_graph.h"
+
+#include <QtTest>
+
+using namespace ROSProjectManager::Internal;
+
+/**
+ * @brief Test of the workspace package dependency graph used for the build order and the code model updates.
+ */
+class PackageGraphTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void topologicalOrder();
+    void dependencyTypes();
+    void affectedPackages();
+    void cycles();
+    void packageForFile();
+
+private:
+    static ROSUtils::PackageInfo package(const QString &name,
+                                         const QStringList &buildDepends,
+                                         const QStringList &execDepends = QStringList(),
+                                         const QStringList &testDepends = QStringList());
+
+    static ROSUtils::PackageInfoMap workspace();
+};
+
+ROSUtils::PackageInfo PackageGraphTest::package(const QString &name,
+                                                const QStringList &buildDepends,
+                                                const QStringList &execDepends,
+                                                const QStringList &testDepends)
+{
+    ROSUtils::PackageInfo info;
+    info.name = name;
+    info.path = Utils::FilePath::fromString(QLatin1String("/ws/src/") + name);
+    info.buildDepends = buildDepends;
+    info.execDepends = execDepends;
+    info.testDepends = testDepends;
+    return info;
+}
+
+ROSUtils::PackageInfoMap PackageGraphTest::workspace()
+{
+    // roscpp is an underlay package, it is not part of the graph
+    ROSUtils::PackageInfoMap packages;
+    packages.insert("a", package("a", {"roscpp"}));
+    packages.insert("b", package("b", {"a"}));
+    packages.insert("c", package("c", {"b", "a"}));
+    packages.insert("d", package("d", {}, {"a"}));
+    packages.insert("e", package("e", {}, {}, {"c"}));
+    return packages;
+}
+
+void PackageGraphTest::topologicalOrder()
+{
+    const ROSPackageDependencyGraph graph(workspace());
+
+    QCOMPARE(graph.packages(), QStringList({"a", "b", "c", "d", "e"}));
+    QCOMPARE(graph.topologicalOrder(), QStringList({"a", "b", "c", "d", "e"}));
+    QCOMPARE(graph.dependencies("a"), QStringList());
+    QCOMPARE(graph.dependencies("c"), QStringList({"a", "b"}));
+    QCOMPARE(graph.dependents("a"), QStringList({"b", "c", "d"}));
+    QVERIFY(graph.cycles().isEmpty());
+}
+
+void PackageGraphTest::dependencyTypes()
+{
+    const ROSPackageDependencyGraph graph(workspace(), ROSPackageDependencyGraph::BuildDependency);
+
+    QCOMPARE(graph.dependencies("d"), QStringList());
+    QCOMPARE(graph.dependencies("e"), QStringList());
+    QCOMPARE(graph.dependents("c"), QStringList());
+}
+
+void PackageGraphTest::affectedPackages()
+{
+    const ROSPackageDependencyGraph graph(workspace());
+
+    QCOMPARE(graph.affectedPackages({"b"}), QStringList({"b", "c", "e"}));
+    QCOMPARE(graph.affectedPackages({"d", "unknown"}), QStringList({"d"}));
+    QCOMPARE(graph.affectedPackages({"a"}), QStringList({"a", "b", "c", "d", "e"}));
+    QCOMPARE(graph.reverseDependencies("c"), QStringList({"e"}));
+    QCOMPARE(graph.reverseDependencies("unknown"), QStringList());
+}
+
+void PackageGraphTest::cycles()
+{
+    ROSUtils::PackageInfoMap packages;
+    packages.insert("u", package("u", {}));
+    packages.insert("v", package("v", {"x"}));
+    packages.insert("w", package("w", {"w"}));
+    packages.insert("x", package("x", {"y"}));
+    packages.insert("y", package("y", {"z"}));
+    packages.insert("z", package("z", {}, {"x"}));
+    const ROSPackageDependencyGraph graph(packages);
+
+    // A package depending on itself is a cycle, a package depending on a cycle is not
+    QCOMPARE(graph.cycles(), QList<QStringList>({{"w"}, {"x", "y", "z"}}));
+
+    // Packages in or behind a cycle follow all other packages in name order
+    QCOMPARE(graph.topologicalOrder(), QStringList({"u", "v", "w", "x", "y", "z"}));
+    QCOMPARE(graph.affectedPackages({"y"}), QStringList({"v", "x", "y", "z"}));
+}
+
+void PackageGraphTest::packageForFile()
+{
+    const ROSPackageDependencyGraph graph(workspace());
+
+    QCOMPARE(graph.packageForFile(Utils::FilePath::fromString("/ws/src/b/src/main.cpp")), QString("b"));
+    QCOMPARE(graph.packageForFile(Utils::FilePath::fromString("/ws/src/b")), QString("b"));
+    QCOMPARE(graph.packageForFile(Utils::FilePath::fromString("/ws/src/bb/src/main.cpp")), QString());
+    QCOMPARE(graph.packagesAffectedByFile(Utils::FilePath::fromString("/ws/src/c/CMakeLists.txt")), QStringList({"c", "e"}));
+}
+
+QTEST_GUILESS_MAIN(PackageGraphTest)
+
+#include "tst_package_graph.moc"